@@ -1,236 +1,33 @@
-#include "st7735.h"
+#include <string.h>
 
-#define ST7735_MADCTL_MY  				0x80
-#define ST7735_MADCTL_MX  				0x40
-#define ST7735_MADCTL_MV  				0x20
-#define ST7735_MADCTL_ML  				0x10
-#define ST7735_MADCTL_RGB 				0x00
-#define ST7735_MADCTL_BGR 				0x08
-#define ST7735_MADCTL_MH  				0x04
-
-#define ST7735_XSTART 					2
-#define ST7735_YSTART 					3
-
-#define ST7735_NOP     					0x00
-#define ST7735_SWRESET 					0x01
-#define ST7735_RDDID   					0x04
-#define ST7735_RDDST   					0x09
-
-#define ST7735_SLPIN   					0x10
-#define ST7735_SLPOUT  					0x11
-#define ST7735_PTLON   					0x12
-#define ST7735_NORON   					0x13
-
-#define ST7735_INVOFF  					0x20
-#define ST7735_INVON   					0x21
-#define ST7735_DISPOFF 					0x28
-#define ST7735_DISPON  					0x29
-#define ST7735_SET_COLUMN_ADDR   		0x2A
-#define ST7735_SET_ROW_ADDR   			0x2B
-#define ST7735_RAMWR   					0x2C
-#define ST7735_RAMRD   					0x2E
-
-#define ST7735_PTLAR   					0x30
-#define ST7735_COLMOD  					0x3A
-#define ST7735_MADCTL  					0x36
-
-#define ST7735_FRMCTR1 					0xB1
-#define ST7735_FRMCTR2 					0xB2
-#define ST7735_FRMCTR3 					0xB3
-#define ST7735_INVCTR  					0xB4
-#define ST7735_DISSET5 					0xB6
-
-#define ST7735_PWCTR1  					0xC0
-#define ST7735_PWCTR2  					0xC1
-#define ST7735_PWCTR3  					0xC2
-#define ST7735_PWCTR4  					0xC3
-#define ST7735_PWCTR5  					0xC4
-#define ST7735_VMCTR1  					0xC5
-
-#define ST7735_RDID1   					0xDA
-#define ST7735_RDID2   					0xDB
-#define ST7735_RDID3   					0xDC
-#define ST7735_RDID4   					0xDD
-
-#define ST7735_PWCTR6  					0xFC
-
-#define ST7735_GMCTRP1 					0xE0
-#define ST7735_GMCTRN1 					0xE1
-
-#define ST7735_ROTATION 				(ST7735_MADCTL_MX | ST7735_MADCTL_MY | ST7735_MADCTL_BGR)
-#define ST7735_COLOR565(r, g, b) 		(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xF8) >> 3))
-
-static uint8_t init_cmds1[] =
-{
-	/*!< 15 commands in list */
-	15,
-
-	/*!< Software reset: 150 ms delay */
-	ST7735_SWRESET,
-	0x80,
-	150,
-
-	/*!< Out of sleep mode: 500 ms delay */
-	ST7735_SLPOUT,
-	0x80,
-	255,
-
-	/*!< Frame rate control: normal mode */
-	ST7735_FRMCTR1,
-	3,
-	0x01,
-	0x2C,
-	0x2D,
-
-	/*!< Frame rate control: idle mode */
-	ST7735_FRMCTR2,
-	3,
-	0x01,
-	0x2C,
-	0x2D,
-
-	/*!< Frame rate control: partial mode */
-	ST7735_FRMCTR3,
-	6,
-	0x01,
-	0x2C,
-	0x2D,
-	0x01,
-	0x2C,
-	0x2D,
-
-	/*!< Display inverse control: no inverse */
-	ST7735_INVCTR,
-	1,
-	0x07,
-
-	/*!< Power control: -4.6V, mode auto */
-	ST7735_PWCTR1,
-	3,
-	0xA2,
-	0x02,
-	0x84,
-
-	/*!< Power control: VGH25 = 2.4C, VGSEL = -10, VGH = 3 * AVDD */
-	ST7735_PWCTR2,
-	1,
-	0xC5,
-
-	/*!< Power control: Opamp current small, boost frequency */
-	ST7735_PWCTR3,
-	2,
-	0x0A,
-	0x00,
-
-	/*!< Power control: BCLK/2, Opamp current small & Medium low */
-	ST7735_PWCTR4,
-	2,
-	0x8A,
-	0x2A,
-
-	/*!< Power control */
-	ST7735_PWCTR5,
-	2,
-	0x8A,
-	0xEE,
-
-	/*!< Power control */
-	ST7735_VMCTR1,
-	1,
-	0x0E,
-
-	/*!< No display inverse */
-	ST7735_INVOFF,
-	0,
-
-	/*!< Memori access control: row_addr/col_addr, bottom to top refresh */
-	ST7735_MADCTL,
-	1,
-	ST7735_ROTATION,
-
-	/*!< Column mode: 16bit color */
-	ST7735_COLMOD,
-	1,
-	0x05
-};
-
-uint8_t init_cmds2[] =
-{
-	/*!<  2 commands in list */
-	2,
-
-	/*!< Set column address: START = 0, END = 127 */
-	ST7735_SET_COLUMN_ADDR,
-	4,
-	0x00,
-	0x00,
-	0x00,
-	0x7F,
-
-	/*!< Set row address: START = 0, END = 127 */
-	ST7735_SET_ROW_ADDR,
-	4,
-	0x00,
-	0x00,
-	0x00,
-	0x7F
-};
-
-uint8_t init_cmds3[] =
-{
-	/*!<  4 commands in list */
-	4,
-
-	/*!<  Magical unicorn dust */
-	ST7735_GMCTRP1,
-	16,
-	0x02,
-	0x1c,
-	0x07,
-	0x12,
-	0x37,
-	0x32,
-	0x29,
-	0x2d,
-	0x29,
-	0x25,
-	0x2B,
-	0x39,
-	0x00,
-	0x01,
-	0x03,
-	0x10,
-
-	/*!<  Sparkles and rainbows */
-	ST7735_GMCTRN1,
-	16,
-	0x03,
-	0x1d,
-	0x07,
-	0x06,
-	0x2E,
-	0x2C,
-	0x29,
-	0x2D,
-	0x2E,
-	0x2E,
-	0x37,
-	0x3F,
-	0x00,
-	0x00,
-	0x02,
-	0x10,
-
-	/*!<  Normal display on; 10 ms delay */
-	ST7735_NORON,
-	0x80,
-	10,
-
-	/*!<  Main screen turn on; 100 ms delay */
-	ST7735_DISPON,
-	0x80,
-	100
-};
+#include "st7735.h"
+#include "st7735_queue.h"
+#include "st7735_regs.h"
+
+#define ST7735_QUEUE_BATCH 				16		/*!< Commands merged and sent under one CS assertion */
+#define ST7735_TX_BUF_LEN 				192		/*!< Transmit buffer length, holds 96 pixels in 16-bit or 64 pixels in 18-bit mode */
+#define ST7735_TILE_SIZE 				16		/*!< Tile edge compared by st7735_present_frame */
+#define ST7735_TILE_MAX_COL 			((162 + ST7735_TILE_SIZE - 1) / ST7735_TILE_SIZE)	/*!< Tiles across the longest GRAM edge */
+#define ST7735_TILE_MAX 				(ST7735_TILE_MAX_COL * ((132 + ST7735_TILE_SIZE - 1) / ST7735_TILE_SIZE))	/*!< Tiles covering the 132x162 GRAM */
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define ST7735_HOST_BIG_ENDIAN 			1
+#else
+#define ST7735_HOST_BIG_ENDIAN 			0
+#endif
+
+typedef struct {
+	int16_t 				x0;				/*!< Left edge, inclusive */
+	int16_t 				y0;				/*!< Top edge, inclusive */
+	int16_t 				x1;				/*!< Right edge, exclusive */
+	int16_t 				y1;				/*!< Bottom edge, exclusive */
+} clip_rect_t;
+
+typedef struct {
+	int16_t 				origin_x;		/*!< Local x origin in screen coordinates */
+	int16_t 				origin_y;		/*!< Local y origin in screen coordinates */
+	clip_rect_t 			clip;			/*!< Clip rectangle in screen coordinates */
+} view_t;
 
 typedef struct st7735 {
 	uint16_t  				width;			/*!< Screen width */
@@ -241,27 +38,164 @@ typedef struct st7735 {
 	st7735_func_set_gpio    set_bckl;       /*!< Function on/off LED backlight */
 	st7735_func_spi_send 	spi_send;		/*!< Function send SPI data */
 	st7735_func_delay 		delay; 			/*!< Function delay */
+	void 					*user_data;		/*!< User context passed to context callbacks */
+	st7735_func_set_gpio_ctx set_cs_ctx; 	/*!< Function set CS with user context */
+	st7735_func_set_gpio_ctx set_dc_ctx; 	/*!< Function set DC with user context */
+	st7735_func_spi_send_ctx spi_send_ctx; 	/*!< Function send SPI data with user context */
+	st7735_func_set_gpio_ctx set_rst_ctx; 	/*!< Function set RST with user context */
+	st7735_func_set_gpio_ctx set_bckl_ctx; 	/*!< Function on/off LED backlight with user context */
+	st7735_func_delay_ctx 	delay_ctx; 		/*!< Function delay with user context */
+	st7735_func_spi_recv 	spi_recv;		/*!< Function receive SPI data */
+	st7735_func_spi_recv_ctx spi_recv_ctx; 	/*!< Function receive SPI data with user context */
+	st7735_func_lock 		lock;			/*!< Function lock the bus */
+	st7735_func_unlock 		unlock;			/*!< Function unlock the bus */
+	st7735_color_mode_t 	color_mode; 	/*!< Interface pixel format */
+	st7735_queue_handle_t 	queue;			/*!< Render queue, draw calls are enqueued if not NULL */
+	st7735_trace_handle_t 	trace;			/*!< Bus tracer, transfers are recorded if not NULL */
 	uint16_t 				pos_x;			/*!< Position x */
 	uint16_t 				pos_y;			/*!< Position y */
+	view_t 					view;			/*!< Current origin and clip rectangle */
+	view_t 					view_stack[ST7735_CLIP_STACK_DEPTH];	/*!< Views saved by push */
+	uint8_t 				view_depth;		/*!< Number of saved views */
+	uint8_t 				stream_width;	/*!< Width of the streamed window */
+	uint8_t 				stream_col;		/*!< Next streamed column */
+	uint8_t 				stream_row;		/*!< Next streamed row */
+	clip_rect_t 			stream_clip;	/*!< Visible part of the streamed window, window relative */
+	uint8_t 				tx_buf[ST7735_TX_BUF_LEN];	/*!< Transmit buffer, lives with the handle so it can sit in DMA-capable memory */
+	bool 					tile_valid;		/*!< Tile hashes describe the panel content */
+	uint32_t 				tile_hash[ST7735_TILE_MAX];	/*!< Hash of each tile of the last presented frame */
 } st7735_t;
 
-static err_code_t st7735_write_cmd(st7735_handle_t handle, uint8_t cmd)
+static void st7735_set_dc(st7735_handle_t handle, uint8_t level)
+{
+	if (handle->set_dc_ctx != NULL)
+	{
+		handle->set_dc_ctx(handle->user_data, level);
+	}
+	else
+	{
+		handle->set_dc(level);
+	}
+}
+
+static err_code_t st7735_set_rst(st7735_handle_t handle, uint8_t level)
+{
+	if (handle->set_rst_ctx != NULL)
+	{
+		return handle->set_rst_ctx(handle->user_data, level);
+	}
+
+	return handle->set_rst(level);
+}
+
+static err_code_t st7735_set_bckl(st7735_handle_t handle, uint8_t level)
 {
-	handle->set_dc(0);
-	handle->spi_send(&cmd, 1);
+	if (handle->set_bckl_ctx != NULL)
+	{
+		return handle->set_bckl_ctx(handle->user_data, level);
+	}
+
+	if (handle->set_bckl != NULL)
+	{
+		return handle->set_bckl(level);
+	}
 
 	return ERR_CODE_SUCCESS;
 }
 
-static err_code_t st7735_write_data(st7735_handle_t handle, uint8_t *data, uint16_t len)
+static void st7735_delay(st7735_handle_t handle, uint32_t time_ms)
+{
+	if (handle->delay_ctx != NULL)
+	{
+		handle->delay_ctx(handle->user_data, time_ms);
+	}
+	else if (handle->delay != NULL)
+	{
+		handle->delay(time_ms);
+	}
+}
+
+static err_code_t st7735_spi_send(st7735_handle_t handle, uint8_t *buf_send, uint16_t len)
+{
+	if (handle->spi_send_ctx != NULL)
+	{
+		return handle->spi_send_ctx(handle->user_data, buf_send, len);
+	}
+
+	return handle->spi_send(buf_send, len);
+}
+
+static err_code_t st7735_select(st7735_handle_t handle)
 {
-	handle->set_dc(1);
-	handle->spi_send(data, len);
+	if ((handle->lock != NULL) && handle->lock(handle->user_data))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	if (handle->set_cs_ctx != NULL)
+	{
+		handle->set_cs_ctx(handle->user_data, 0);
+	}
+	else if (handle->set_cs != NULL)
+	{
+		handle->set_cs(0);
+	}
+
+	if (handle->trace != NULL)
+	{
+		st7735_trace_record(handle->trace, ST7735_TRACE_CS_ASSERT, NULL, 0);
+	}
 
 	return ERR_CODE_SUCCESS;
 }
 
-static err_code_t st7735_write_list_cmd(st7735_handle_t handle, uint8_t *list_cmd)
+static void st7735_deselect(st7735_handle_t handle)
+{
+	if (handle->trace != NULL)
+	{
+		st7735_trace_record(handle->trace, ST7735_TRACE_CS_RELEASE, NULL, 0);
+	}
+
+	if (handle->set_cs_ctx != NULL)
+	{
+		handle->set_cs_ctx(handle->user_data, 1);
+	}
+	else if (handle->set_cs != NULL)
+	{
+		handle->set_cs(1);
+	}
+
+	if (handle->unlock != NULL)
+	{
+		handle->unlock(handle->user_data);
+	}
+}
+
+static err_code_t st7735_write_cmd(st7735_handle_t handle, uint8_t cmd)
+{
+	if (handle->trace != NULL)
+	{
+		st7735_trace_record(handle->trace, ST7735_TRACE_CMD, &cmd, 1);
+	}
+
+	st7735_set_dc(handle, 0);
+
+	return st7735_spi_send(handle, &cmd, 1);
+}
+
+static err_code_t st7735_write_data(st7735_handle_t handle, uint8_t *data, uint16_t len)
+{
+	if (handle->trace != NULL)
+	{
+		st7735_trace_record(handle->trace, ST7735_TRACE_DATA, data, len);
+	}
+
+	st7735_set_dc(handle, 1);
+
+	return st7735_spi_send(handle, data, len);
+}
+
+static err_code_t st7735_write_list_cmd(st7735_handle_t handle, const uint8_t *list_cmd)
 {
 	uint8_t num_cmd, num_arg;
 	uint16_t delay_ms;
@@ -281,7 +215,7 @@ static err_code_t st7735_write_list_cmd(st7735_handle_t handle, uint8_t *list_cm
 		num_arg &= ~0x80;
 		if (num_arg)
 		{
-			if (st7735_write_data(handle, list_cmd, num_arg))
+			if (st7735_write_data(handle, (uint8_t *)list_cmd, num_arg))
 			{
 				return ERR_CODE_FAIL;
 			}
@@ -292,7 +226,7 @@ static err_code_t st7735_write_list_cmd(st7735_handle_t handle, uint8_t *list_cm
 		{
 			delay_ms = *list_cmd++;
 			if (delay_ms == 255) delay_ms = 500;
-			handle->delay(delay_ms);
+			st7735_delay(handle, delay_ms);
 		}
 	}
 
@@ -301,17 +235,21 @@ static err_code_t st7735_write_list_cmd(st7735_handle_t handle, uint8_t *list_cm
 
 static err_code_t st7735_reset(st7735_handle_t handle)
 {
-	if (handle->set_rst != NULL)
+	if ((handle->set_rst_ctx == NULL) && (handle->set_rst == NULL))
 	{
-		handle->set_rst(0);
-		handle->delay(5);
-		handle->set_rst(1);
+		return ERR_CODE_SUCCESS;
 	}
 
-	return ERR_CODE_SUCCESS;
+	if (st7735_set_rst(handle, 0))
+	{
+		return ERR_CODE_FAIL;
+	}
+	st7735_delay(handle, 5);
+
+	return st7735_set_rst(handle, 1);
 }
 
-static err_code_t set_addr(st7735_handle_t handle, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+static err_code_t set_window(st7735_handle_t handle, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
 {
 	uint8_t data[4];
 
@@ -320,76 +258,1920 @@ static err_code_t set_addr(st7735_handle_t handle, uint8_t x0, uint8_t y0, uint8
 	data[2] = 0x00;
 	data[3] = x1 + ST7735_XSTART;
 
-	st7735_write_cmd(handle, ST7735_SET_COLUMN_ADDR);
-	st7735_write_data(handle, data, 4);
+	if (st7735_write_cmd(handle, ST7735_SET_COLUMN_ADDR) || st7735_write_data(handle, data, 4))
+	{
+		return ERR_CODE_FAIL;
+	}
 
 	data[1] = y0 + ST7735_YSTART;
 	data[3] = y1 + ST7735_YSTART;
-	st7735_write_cmd(handle, ST7735_SET_ROW_ADDR);
-	st7735_write_data(handle, data, 4);
 
-	st7735_write_cmd(handle, ST7735_RAMWR);
+	if (st7735_write_cmd(handle, ST7735_SET_ROW_ADDR) || st7735_write_data(handle, data, 4))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t set_addr(st7735_handle_t handle, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+	if (set_window(handle, x0, y0, x1, y1))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	return st7735_write_cmd(handle, ST7735_RAMWR);
+}
+
+static err_code_t st7735_read_data(st7735_handle_t handle, uint8_t *data, uint16_t len)
+{
+	if (handle->trace != NULL)
+	{
+		st7735_trace_record(handle->trace, ST7735_TRACE_READ, NULL, len);
+	}
+
+	st7735_set_dc(handle, 1);
+
+	if (handle->spi_recv_ctx != NULL)
+	{
+		return handle->spi_recv_ctx(handle->user_data, data, len);
+	}
+
+	return handle->spi_recv(data, len);
+}
+
+static bool can_read(st7735_handle_t handle)
+{
+	return (handle->spi_recv_ctx != NULL) || (handle->spi_recv != NULL);
+}
+
+static err_code_t read_pixels(st7735_handle_t handle, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t *buf)
+{
+	uint8_t data[ST7735_TX_BUF_LEN];
+	uint32_t num_pixel = (uint32_t)(x1 - x0 + 1) * (y1 - y0 + 1);
+
+	if (set_window(handle, x0, y0, x1, y1) || st7735_write_cmd(handle, ST7735_RAMRD))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* First byte after RAMRD is a dummy read */
+	if (st7735_read_data(handle, data, 1))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* Memory read always returns 18-bit pixels, 3 bytes each */
+	while (num_pixel)
+	{
+		uint16_t chunk = (num_pixel > ST7735_TX_BUF_LEN / 3) ? ST7735_TX_BUF_LEN / 3 : num_pixel;
+		if (st7735_read_data(handle, data, chunk * 3))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		for (uint16_t idx = 0; idx < chunk; idx++)
+		{
+			*buf++ = ST7735_COLOR565(data[idx * 3], data[idx * 3 + 1], data[idx * 3 + 2]);
+		}
+
+		num_pixel -= chunk;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static uint8_t get_pixel_size(st7735_pixel_format_t format)
+{
+	switch (format)
+	{
+	case ST7735_PIXEL_FORMAT_RGB888:
+		return 3;
+	case ST7735_PIXEL_FORMAT_ARGB8888:
+		return 4;
+	case ST7735_PIXEL_FORMAT_GRAY8:
+		return 1;
+	default:
+		return 2;
+	}
+}
+
+static uint8_t encode_rgb(st7735_handle_t handle, uint8_t *dst, uint8_t r, uint8_t g, uint8_t b)
+{
+	if (handle->color_mode == ST7735_COLOR_MODE_18BIT)
+	{
+		dst[0] = r & 0xFC;
+		dst[1] = g & 0xFC;
+		dst[2] = b & 0xFC;
+		return 3;
+	}
+
+	uint16_t color = ST7735_COLOR565(r, g, b);
+	dst[0] = color >> 8;
+	dst[1] = color & 0xFF;
+
+	return 2;
+}
+
+static uint8_t encode_color(st7735_handle_t handle, uint8_t *dst, uint16_t color)
+{
+	if (handle->color_mode == ST7735_COLOR_MODE_18BIT)
+	{
+		uint8_t r = (color >> 8) & 0xF8;
+		uint8_t g = (color >> 3) & 0xFC;
+		uint8_t b = (color << 3) & 0xF8;
+		return encode_rgb(handle, dst, r | (r >> 5), g | (g >> 6), b | (b >> 5));
+	}
+
+	dst[0] = color >> 8;
+	dst[1] = color & 0xFF;
+
+	return 2;
+}
+
+static uint16_t convert_pixels_16bit(uint8_t *dst, const uint8_t *src, st7735_pixel_format_t format, uint16_t num_pixel)
+{
+	uint16_t idx = 0;
+
+	switch (format)
+	{
+	case ST7735_PIXEL_FORMAT_RGB565_BE:
+		memcpy(dst, src, num_pixel * 2);
+		break;
+
+	case ST7735_PIXEL_FORMAT_RGB565:
+#if ST7735_HOST_BIG_ENDIAN
+		memcpy(dst, src, num_pixel * 2);
+#else
+		/* Swap bytes of four pixels at a time in one 64-bit word */
+		for (; idx + 4 <= num_pixel; idx += 4)
+		{
+			uint64_t word;
+			memcpy(&word, &src[idx * 2], sizeof(word));
+			word = ((word & 0x00FF00FF00FF00FFULL) << 8) | ((word >> 8) & 0x00FF00FF00FF00FFULL);
+			memcpy(&dst[idx * 2], &word, sizeof(word));
+		}
+		for (; idx < num_pixel; idx++)
+		{
+			dst[idx * 2] = src[idx * 2 + 1];
+			dst[idx * 2 + 1] = src[idx * 2];
+		}
+#endif
+		break;
+
+	case ST7735_PIXEL_FORMAT_RGB888:
+		for (; idx < num_pixel; idx++)
+		{
+			const uint8_t *rgb = &src[idx * 3];
+			uint16_t color = ST7735_COLOR565(rgb[0], rgb[1], rgb[2]);
+			dst[idx * 2] = color >> 8;
+			dst[idx * 2 + 1] = color & 0xFF;
+		}
+		break;
+
+	case ST7735_PIXEL_FORMAT_ARGB8888:
+		/* Pack two pixels per 32-bit word, already in wire byte order */
+		for (; idx + 2 <= num_pixel; idx += 2)
+		{
+			uint32_t argb[2];
+			memcpy(argb, &src[idx * 4], sizeof(argb));
+			uint32_t c0 = ((argb[0] >> 8) & 0xF800) | ((argb[0] >> 5) & 0x07E0) | ((argb[0] >> 3) & 0x001F);
+			uint32_t c1 = ((argb[1] >> 8) & 0xF800) | ((argb[1] >> 5) & 0x07E0) | ((argb[1] >> 3) & 0x001F);
+#if ST7735_HOST_BIG_ENDIAN
+			uint32_t word = (c0 << 16) | c1;
+#else
+			uint32_t word = (c0 >> 8) | ((c0 & 0xFF) << 8) | ((c1 >> 8) << 16) | ((c1 & 0xFF) << 24);
+#endif
+			memcpy(&dst[idx * 2], &word, sizeof(word));
+		}
+		for (; idx < num_pixel; idx++)
+		{
+			uint32_t argb;
+			memcpy(&argb, &src[idx * 4], sizeof(argb));
+			uint16_t color = ((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 3) & 0x001F);
+			dst[idx * 2] = color >> 8;
+			dst[idx * 2 + 1] = color & 0xFF;
+		}
+		break;
+
+	case ST7735_PIXEL_FORMAT_GRAY8:
+		for (; idx < num_pixel; idx++)
+		{
+			uint16_t color = ST7735_COLOR565(src[idx], src[idx], src[idx]);
+			dst[idx * 2] = color >> 8;
+			dst[idx * 2 + 1] = color & 0xFF;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return num_pixel * 2;
+}
+
+static uint16_t convert_pixels_18bit(st7735_handle_t handle, uint8_t *dst, const uint8_t *src, st7735_pixel_format_t format, uint16_t num_pixel)
+{
+	uint16_t len = 0;
+
+	for (uint16_t idx = 0; idx < num_pixel; idx++)
+	{
+		switch (format)
+		{
+		case ST7735_PIXEL_FORMAT_RGB565_BE:
+			len += encode_color(handle, &dst[len], (src[idx * 2] << 8) | src[idx * 2 + 1]);
+			break;
+
+		case ST7735_PIXEL_FORMAT_RGB565:
+		{
+			uint16_t color;
+			memcpy(&color, &src[idx * 2], sizeof(color));
+			len += encode_color(handle, &dst[len], color);
+			break;
+		}
+
+		case ST7735_PIXEL_FORMAT_RGB888:
+			len += encode_rgb(handle, &dst[len], src[idx * 3], src[idx * 3 + 1], src[idx * 3 + 2]);
+			break;
+
+		case ST7735_PIXEL_FORMAT_ARGB8888:
+		{
+			uint32_t argb;
+			memcpy(&argb, &src[idx * 4], sizeof(argb));
+			len += encode_rgb(handle, &dst[len], (argb >> 16) & 0xFF, (argb >> 8) & 0xFF, argb & 0xFF);
+			break;
+		}
+
+		case ST7735_PIXEL_FORMAT_GRAY8:
+			len += encode_rgb(handle, &dst[len], src[idx], src[idx], src[idx]);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return len;
+}
+
+static err_code_t write_pixels(st7735_handle_t handle, const uint8_t *src, st7735_pixel_format_t format, uint32_t num_pixel)
+{
+	/* Data already in wire format, send without copying */
+	if ((format == ST7735_PIXEL_FORMAT_RGB565_BE) && (handle->color_mode == ST7735_COLOR_MODE_16BIT))
+	{
+		while (num_pixel)
+		{
+			uint16_t chunk = (num_pixel > 0x7FFF) ? 0x7FFF : num_pixel;
+			if (st7735_write_data(handle, (uint8_t *)src, chunk * 2))
+			{
+				return ERR_CODE_FAIL;
+			}
+			src += chunk * 2;
+			num_pixel -= chunk;
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	uint8_t *buf = handle->tx_buf;
+	uint8_t src_size = get_pixel_size(format);
+	uint16_t max_pixel = ST7735_TX_BUF_LEN / ((handle->color_mode == ST7735_COLOR_MODE_18BIT) ? 3 : 2);
+
+	while (num_pixel)
+	{
+		uint16_t chunk = (num_pixel > max_pixel) ? max_pixel : num_pixel;
+		uint16_t len;
+
+		if (handle->color_mode == ST7735_COLOR_MODE_18BIT)
+		{
+			len = convert_pixels_18bit(handle, buf, src, format, chunk);
+		}
+		else
+		{
+			len = convert_pixels_16bit(buf, src, format, chunk);
+		}
+
+		if (st7735_write_data(handle, buf, len))
+		{
+			return ERR_CODE_FAIL;
+		}
+		src += chunk * src_size;
+		num_pixel -= chunk;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t write_color_repeat(st7735_handle_t handle, uint16_t color, uint32_t num_pixel)
+{
+	uint8_t *buf = handle->tx_buf;
+	uint8_t pixel_size = encode_color(handle, buf, color);
+	uint16_t max_pixel = ST7735_TX_BUF_LEN / pixel_size;
+	uint16_t fill_pixel = (num_pixel < max_pixel) ? num_pixel : max_pixel;
+
+	for (uint16_t idx = 1; idx < fill_pixel; idx++)
+	{
+		memcpy(&buf[idx * pixel_size], buf, pixel_size);
+	}
+
+	while (num_pixel)
+	{
+		uint16_t chunk = (num_pixel > max_pixel) ? max_pixel : num_pixel;
+		if (st7735_write_data(handle, buf, chunk * pixel_size))
+		{
+			return ERR_CODE_FAIL;
+		}
+		num_pixel -= chunk;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static bool clip_rect(st7735_handle_t handle, int16_t x, int16_t y, int16_t width, int16_t height, clip_rect_t *area)
+{
+	const clip_rect_t *clip = &handle->view.clip;
+
+	x += handle->view.origin_x;
+	y += handle->view.origin_y;
+
+	area->x0 = (x > clip->x0) ? x : clip->x0;
+	area->y0 = (y > clip->y0) ? y : clip->y0;
+	area->x1 = (x + width < clip->x1) ? x + width : clip->x1;
+	area->y1 = (y + height < clip->y1) ? y + height : clip->y1;
+
+	return (area->x0 < area->x1) && (area->y0 < area->y1);
+}
+
+static err_code_t put_pixel(st7735_handle_t handle, int16_t x, int16_t y, uint16_t color)
+{
+	if (set_addr(handle, x, y, x + 1, y + 1))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint8_t data[3];
+
+	return st7735_write_data(handle, data, encode_color(handle, data, color));
+}
+
+static err_code_t fill_area(st7735_handle_t handle, const clip_rect_t *area, uint16_t color)
+{
+	if (set_addr(handle, area->x0, area->y0, area->x1 - 1, area->y1 - 1))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	return write_color_repeat(handle, color, (uint32_t)(area->x1 - area->x0) * (area->y1 - area->y0));
+}
+
+static err_code_t draw_pixel(st7735_handle_t handle, int16_t x, int16_t y, uint16_t color)
+{
+	const clip_rect_t *clip = &handle->view.clip;
+
+	x += handle->view.origin_x;
+	y += handle->view.origin_y;
+
+	if ((x < clip->x0) || (x >= clip->x1) || (y < clip->y0) || (y >= clip->y1))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	return put_pixel(handle, x, y, color);
+}
+
+static err_code_t fill_rect(st7735_handle_t handle, int16_t x_origin, int16_t y_origin, uint16_t width, uint16_t height, uint16_t color)
+{
+	clip_rect_t area;
+
+	if (!clip_rect(handle, x_origin, y_origin, width, height, &area))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	return fill_area(handle, &area, color);
+}
+
+#define OUTCODE_LEFT 					0x01
+#define OUTCODE_RIGHT 					0x02
+#define OUTCODE_TOP 					0x04
+#define OUTCODE_BOTTOM 					0x08
+
+static uint8_t get_outcode(const clip_rect_t *clip, int32_t x, int32_t y)
+{
+	uint8_t code = 0;
+
+	if (x < clip->x0)
+	{
+		code |= OUTCODE_LEFT;
+	}
+	else if (x >= clip->x1)
+	{
+		code |= OUTCODE_RIGHT;
+	}
+
+	if (y < clip->y0)
+	{
+		code |= OUTCODE_TOP;
+	}
+	else if (y >= clip->y1)
+	{
+		code |= OUTCODE_BOTTOM;
+	}
+
+	return code;
+}
+
+static bool clip_line(const clip_rect_t *clip, int32_t *x_start, int32_t *y_start, int32_t *x_end, int32_t *y_end)
+{
+	uint8_t code_start = get_outcode(clip, *x_start, *y_start);
+	uint8_t code_end = get_outcode(clip, *x_end, *y_end);
+
+	/* Cohen-Sutherland, move an outside endpoint onto the edge it crosses */
+	while (code_start | code_end)
+	{
+		if (code_start & code_end)
+		{
+			return false;
+		}
+
+		uint8_t code = code_start ? code_start : code_end;
+		int32_t dx = *x_end - *x_start;
+		int32_t dy = *y_end - *y_start;
+		int32_t x, y;
+
+		if (code & OUTCODE_TOP)
+		{
+			y = clip->y0;
+			x = *x_start + dx * (y - *y_start) / dy;
+		}
+		else if (code & OUTCODE_BOTTOM)
+		{
+			y = clip->y1 - 1;
+			x = *x_start + dx * (y - *y_start) / dy;
+		}
+		else if (code & OUTCODE_RIGHT)
+		{
+			x = clip->x1 - 1;
+			y = *y_start + dy * (x - *x_start) / dx;
+		}
+		else
+		{
+			x = clip->x0;
+			y = *y_start + dy * (x - *x_start) / dx;
+		}
+
+		if (code == code_start)
+		{
+			*x_start = x;
+			*y_start = y;
+			code_start = get_outcode(clip, x, y);
+		}
+		else
+		{
+			*x_end = x;
+			*y_end = y;
+			code_end = get_outcode(clip, x, y);
+		}
+	}
+
+	return true;
+}
+
+static err_code_t draw_line(st7735_handle_t handle, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+	const clip_rect_t *clip = &handle->view.clip;
+	int32_t x_start = x0 + handle->view.origin_x;
+	int32_t y_start = y0 + handle->view.origin_y;
+	int32_t x_end = x1 + handle->view.origin_x;
+	int32_t y_end = y1 + handle->view.origin_y;
+	int32_t clip_x_start = x_start, clip_y_start = y_start, clip_x_end = x_end, clip_y_end = y_end;
+
+	if (!clip_line(clip, &clip_x_start, &clip_y_start, &clip_x_end, &clip_y_end))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	/* Straight lines go out as one window */
+	if ((x_start == x_end) || (y_start == y_end))
+	{
+		clip_rect_t area = {
+			(clip_x_start < clip_x_end) ? clip_x_start : clip_x_end,
+			(clip_y_start < clip_y_end) ? clip_y_start : clip_y_end,
+			((clip_x_start < clip_x_end) ? clip_x_end : clip_x_start) + 1,
+			((clip_y_start < clip_y_end) ? clip_y_end : clip_y_start) + 1,
+		};
+
+		return fill_area(handle, &area, color);
+	}
+
+	int32_t deltaX = abs(x_end - x_start);
+	int32_t deltaY = abs(y_end - y_start);
+	int32_t signX = ((x_start < x_end) ? 1 : -1);
+	int32_t signY = ((y_start < y_end) ? 1 : -1);
+	int32_t error = deltaX - deltaY;
+	int32_t error2;
+	bool entered = false;
+
+	/* Jump to the first step inside the entering edges of the clip rectangle.
+	 * After k major-axis steps the minor axis has moved
+	 * floor((2 * k * minor + major - 1) / (2 * major)) and the error term
+	 * follows, so the pixels match a line stepped from its start. */
+	int64_t major = (deltaX >= deltaY) ? deltaX : deltaY;
+	int64_t minor = (deltaX >= deltaY) ? deltaY : deltaX;
+	int64_t dist_x = (signX > 0) ? clip->x0 - x_start : x_start - (clip->x1 - 1);
+	int64_t dist_y = (signY > 0) ? clip->y0 - y_start : y_start - (clip->y1 - 1);
+	int64_t dist_major = (deltaX >= deltaY) ? dist_x : dist_y;
+	int64_t dist_minor = (deltaX >= deltaY) ? dist_y : dist_x;
+	int64_t num_step = (dist_major > 0) ? dist_major : 0;
+
+	if ((dist_minor > 0) && (minor > 0))
+	{
+		int64_t minor_step = ((2 * dist_minor - 1) * major + 2 * minor) / (2 * minor);
+		num_step = (minor_step > num_step) ? minor_step : num_step;
+	}
+
+	if (num_step > major)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	if (num_step > 0)
+	{
+		int64_t num_minor = (2 * num_step * minor + major - 1) / (2 * major);
+
+		if (deltaX >= deltaY)
+		{
+			x_start += signX * num_step;
+			y_start += signY * num_minor;
+			error = deltaX - deltaY - num_step * deltaY + num_minor * deltaX;
+		}
+		else
+		{
+			y_start += signY * num_step;
+			x_start += signX * num_minor;
+			error = deltaX - deltaY + num_step * deltaX - num_minor * deltaY;
+		}
+	}
+
+	/* Only pixels inside the clip rectangle reach the bus */
+	while (true)
+	{
+		if (get_outcode(clip, x_start, y_start) == 0)
+		{
+			if (put_pixel(handle, x_start, y_start, color))
+			{
+				return ERR_CODE_FAIL;
+			}
+			entered = true;
+		}
+		else if (entered)
+		{
+			break;
+		}
+
+		if ((x_start == x_end) && (y_start == y_end))
+		{
+			break;
+		}
+
+		error2 = error * 2;
+		if (error2 > -deltaY) {
+			error -= deltaY;
+			x_start += signX;
+		} else {
+			/*nothing to do*/
+		}
+
+		if (error2 < deltaX) {
+			error += deltaX;
+			y_start += signY;
+		} else {
+			/*nothing to do*/
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t draw_rectangle(st7735_handle_t handle, int16_t x_origin, int16_t y_origin, uint16_t width, uint16_t height, uint16_t color)
+{
+	if (draw_line(handle, x_origin, y_origin, x_origin + width, y_origin, color) ||
+	        draw_line(handle, x_origin + width, y_origin, x_origin + width, y_origin + height, color) ||
+	        draw_line(handle, x_origin + width, y_origin + height, x_origin, y_origin + height, color) ||
+	        draw_line(handle, x_origin, y_origin + height, x_origin, y_origin, color))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static bool circle_visible(st7735_handle_t handle, int16_t x_origin, int16_t y_origin, uint8_t radius)
+{
+	const clip_rect_t *clip = &handle->view.clip;
+	int32_t cx = x_origin + handle->view.origin_x;
+	int32_t cy = y_origin + handle->view.origin_y;
+
+	/* Bounding box misses the clip rectangle */
+	if ((cx + radius < clip->x0) || (cx - radius >= clip->x1) || (cy + radius < clip->y0) || (cy - radius >= clip->y1))
+	{
+		return false;
+	}
+
+	/* Clip rectangle lies inside the circle, clear of the outline */
+	int32_t dx = ((cx - clip->x0) > (clip->x1 - 1 - cx)) ? (cx - clip->x0) : (clip->x1 - 1 - cx);
+	int32_t dy = ((cy - clip->y0) > (clip->y1 - 1 - cy)) ? (cy - clip->y0) : (clip->y1 - 1 - cy);
+	int32_t inner = (int32_t)radius - 1;
+
+	return (inner <= 0) || (dx * dx + dy * dy >= inner * inner);
+}
+
+static err_code_t draw_circle(st7735_handle_t handle, int16_t x_origin, int16_t y_origin, uint8_t radius, uint16_t color)
+{
+	int32_t x = -radius;
+	int32_t y = 0;
+	int32_t err = 2 - 2 * radius;
+	int32_t e2;
+
+	if (!circle_visible(handle, x_origin, y_origin, radius))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	do {
+		if (draw_pixel(handle, x_origin - x, y_origin + y, color) ||
+		        draw_pixel(handle, x_origin + x, y_origin + y, color) ||
+		        draw_pixel(handle, x_origin + x, y_origin - y, color) ||
+		        draw_pixel(handle, x_origin - x, y_origin - y, color))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		e2 = err;
+		if (e2 <= y) {
+			y++;
+			err = err + (y * 2 + 1);
+			if (-x == y && e2 <= x) {
+				e2 = 0;
+			}
+			else {
+				/*nothing to do*/
+			}
+		} else {
+			/*nothing to do*/
+		}
+
+		if (e2 > x) {
+			x++;
+			err = err + (x * 2 + 1);
+		} else {
+			/*nothing to do*/
+		}
+	} while (x <= 0);
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t write_char(st7735_handle_t handle, font_size_t font_size, uint8_t chr, uint16_t color)
+{
+	st7735_glyph_t glyph;
+	st7735_get_glyph(font_size, chr, &glyph);
+
+	clip_rect_t area;
+
+	/* Glyph outside the clip rectangle only advances the position */
+	if (!clip_rect(handle, handle->pos_x, handle->pos_y, glyph.stride * 8, glyph.height, &area))
+	{
+		handle->pos_x += glyph.advance;
+		return ERR_CODE_SUCCESS;
+	}
+
+	for (uint8_t height_idx = 0; height_idx < glyph.height; height_idx++)
+	{
+		for (uint8_t width_idx = 0; width_idx < glyph.stride * 8; width_idx++)
+		{
+			int16_t x = handle->pos_x + width_idx;
+			int16_t y = handle->pos_y + height_idx;
+			if (ST7735_GLYPH_PIXEL(&glyph, height_idx, width_idx) && draw_pixel(handle, x, y, color))
+			{
+				return ERR_CODE_FAIL;
+			}
+		}
+	}
+
+	handle->pos_x += glyph.advance;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t write_char_bg(st7735_handle_t handle, font_size_t font_size, uint8_t chr, uint16_t color, uint16_t bg_color)
+{
+	st7735_glyph_t glyph;
+	st7735_get_glyph(font_size, chr, &glyph);
+
+	uint8_t cell_width = glyph.advance;
+	uint8_t fg_data[3], bg_data[3];
+	uint8_t pixel_size = encode_color(handle, fg_data, color);
+	encode_color(handle, bg_data, bg_color);
+
+	/* Whole glyph cell goes out in one window, background included */
+	uint8_t *buf = handle->tx_buf;
+	uint16_t len = 0;
+	clip_rect_t area;
+
+	if (!clip_rect(handle, handle->pos_x, handle->pos_y, cell_width, glyph.height, &area))
+	{
+		handle->pos_x += cell_width;
+		return ERR_CODE_SUCCESS;
+	}
+
+	/* Only the visible part of the cell is sent */
+	int16_t cell_x = handle->pos_x + handle->view.origin_x;
+	int16_t cell_y = handle->pos_y + handle->view.origin_y;
+	if (set_addr(handle, area.x0, area.y0, area.x1 - 1, area.y1 - 1))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	for (uint8_t height_idx = area.y0 - cell_y; height_idx < area.y1 - cell_y; height_idx++)
+	{
+		for (uint8_t width_idx = area.x0 - cell_x; width_idx < area.x1 - cell_x; width_idx++)
+		{
+			bool set = ST7735_GLYPH_PIXEL(&glyph, height_idx, width_idx);
+			memcpy(&buf[len], set ? fg_data : bg_data, pixel_size);
+			len += pixel_size;
+
+			if (len + pixel_size > ST7735_TX_BUF_LEN)
+			{
+				if (st7735_write_data(handle, buf, len))
+				{
+					return ERR_CODE_FAIL;
+				}
+				len = 0;
+			}
+		}
+	}
+
+	if (len && st7735_write_data(handle, buf, len))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->pos_x += cell_width;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t draw_image(st7735_handle_t handle, int16_t x_origin, int16_t y_origin, uint8_t width, uint8_t height, const void *image_src, st7735_pixel_format_t format)
+{
+	clip_rect_t area;
+
+	if (!clip_rect(handle, x_origin, y_origin, width, height, &area))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	if (set_addr(handle, area.x0, area.y0, area.x1 - 1, area.y1 - 1))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint8_t area_width = area.x1 - area.x0;
+	if (area_width == width)
+	{
+		const uint8_t *src = (const uint8_t *)image_src + (area.y0 - y_origin - handle->view.origin_y) * width * get_pixel_size(format);
+		return write_pixels(handle, src, format, (uint32_t)width * (area.y1 - area.y0));
+	}
+
+	/* Clipped columns, the window wraps so each row continues where the last ended */
+	uint8_t pixel_size = get_pixel_size(format);
+	uint8_t col = area.x0 - x_origin - handle->view.origin_x;
+	for (int16_t y = area.y0; y < area.y1; y++)
+	{
+		uint8_t row = y - y_origin - handle->view.origin_y;
+		if (write_pixels(handle, (const uint8_t *)image_src + ((uint32_t)row * width + col) * pixel_size, format, area_width))
+		{
+			return ERR_CODE_FAIL;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static uint32_t hash_tile(const uint8_t *frame, uint16_t stride, uint8_t width, uint8_t height)
+{
+	uint32_t hash = 0x811C9DC5;
+
+	for (uint8_t row = 0; row < height; row++)
+	{
+		const uint8_t *src = &frame[row * stride];
+		uint8_t idx = 0;
+
+		/* Four bytes per step, the tail of odd widths is mixed two bytes at a time */
+		for (; idx + 4 <= width * 2; idx += 4)
+		{
+			uint32_t word;
+			memcpy(&word, &src[idx], 4);
+			hash = (hash ^ word) * 0x01000193;
+			hash ^= hash >> 15;
+		}
+
+		for (; idx < width * 2; idx += 2)
+		{
+			hash = (hash ^ ((src[idx] << 8) | src[idx + 1])) * 0x01000193;
+		}
+	}
+
+	return hash;
+}
+
+static err_code_t send_tiles(st7735_handle_t handle, const uint8_t *frame, uint8_t col_start, uint8_t col_end, uint8_t row_start, uint8_t row_end)
+{
+	uint16_t x0 = col_start * ST7735_TILE_SIZE;
+	uint16_t y0 = row_start * ST7735_TILE_SIZE;
+	uint16_t x1 = (col_end * ST7735_TILE_SIZE < handle->width) ? col_end * ST7735_TILE_SIZE : handle->width;
+	uint16_t y1 = (row_end * ST7735_TILE_SIZE < handle->height) ? row_end * ST7735_TILE_SIZE : handle->height;
+
+	if (set_addr(handle, x0, y0, x1 - 1, y1 - 1))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	for (uint16_t y = y0; y < y1; y++)
+	{
+		if (write_pixels(handle, &frame[((uint32_t)y * handle->width + x0) * 2], ST7735_PIXEL_FORMAT_RGB565_BE, x1 - x0))
+		{
+			return ERR_CODE_FAIL;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t present_frame(st7735_handle_t handle, const uint8_t *frame, uint16_t *num_rect)
+{
+	uint16_t num_col = (handle->width + ST7735_TILE_SIZE - 1) / ST7735_TILE_SIZE;
+	uint16_t num_row = (handle->height + ST7735_TILE_SIZE - 1) / ST7735_TILE_SIZE;
+	uint16_t stride = handle->width * 2;
+
+	/* Hash table and open runs are sized for the 132x162 GRAM in either orientation */
+	if ((num_col > ST7735_TILE_MAX_COL) || (num_row > ST7735_TILE_MAX_COL) || (num_col * num_row > ST7735_TILE_MAX))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* Runs of changed tiles still open from the rows above, extended while the next row repeats them */
+	struct {
+		uint8_t col_start;
+		uint8_t col_end;
+		uint8_t row_start;
+		bool 	matched;
+	} open[2 * ST7735_TILE_MAX_COL];
+	uint8_t num_open = 0;
+	uint16_t count = 0;
+
+	for (uint8_t row = 0; row <= num_row; row++)
+	{
+		for (uint8_t idx = 0; idx < num_open; idx++)
+		{
+			open[idx].matched = false;
+		}
+
+		uint8_t col = 0;
+		while (row < num_row && col < num_col)
+		{
+			bool changed = false;
+			uint8_t run_start = col;
+
+			for (; col < num_col; col++)
+			{
+				uint8_t tile_width = (handle->width - col * ST7735_TILE_SIZE < ST7735_TILE_SIZE) ? handle->width - col * ST7735_TILE_SIZE : ST7735_TILE_SIZE;
+				uint8_t tile_height = (handle->height - row * ST7735_TILE_SIZE < ST7735_TILE_SIZE) ? handle->height - row * ST7735_TILE_SIZE : ST7735_TILE_SIZE;
+				uint32_t hash = hash_tile(&frame[row * ST7735_TILE_SIZE * stride + col * ST7735_TILE_SIZE * 2], stride, tile_width, tile_height);
+				uint32_t *stored = &handle->tile_hash[row * num_col + col];
+				bool tile_changed = !handle->tile_valid || (*stored != hash);
+
+				*stored = hash;
+				if (!tile_changed)
+				{
+					break;
+				}
+				changed = true;
+			}
+
+			if (!changed)
+			{
+				col++;
+				continue;
+			}
+
+			/* Same columns as an open run grow it downwards, anything else opens a new run */
+			uint8_t idx = 0;
+			while ((idx < num_open) && ((open[idx].col_start != run_start) || (open[idx].col_end != col)))
+			{
+				idx++;
+			}
+
+			if (idx == num_open)
+			{
+				open[num_open].col_start = run_start;
+				open[num_open].col_end = col;
+				open[num_open].row_start = row;
+				num_open++;
+			}
+			open[idx].matched = true;
+
+			/* The tile that ended the run is unchanged */
+			col++;
+		}
+
+		/* Runs not continued by this row are complete */
+		for (uint8_t idx = 0; idx < num_open;)
+		{
+			if (open[idx].matched)
+			{
+				idx++;
+				continue;
+			}
+
+			/* Hashes already describe this frame, force a full resend next time */
+			if (send_tiles(handle, frame, open[idx].col_start, open[idx].col_end, open[idx].row_start, row))
+			{
+				handle->tile_valid = false;
+				return ERR_CODE_FAIL;
+			}
+			count++;
+			open[idx] = open[--num_open];
+		}
+	}
+
+	handle->tile_valid = true;
+
+	if (num_rect != NULL)
+	{
+		*num_rect = count;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t set_color_mode(st7735_handle_t handle, st7735_color_mode_t color_mode)
+{
+	uint8_t colmod = color_mode;
+	if (st7735_write_cmd(handle, ST7735_COLMOD) || st7735_write_data(handle, &colmod, 1))
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->color_mode = color_mode;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static uint8_t get_mask_alpha(uint8_t *mask, st7735_mask_bpp_t mask_bpp, uint16_t stride, uint8_t row, uint8_t col)
+{
+	if (mask_bpp == ST7735_MASK_1BPP)
+	{
+		return ((mask[row * stride + col / 8] << (col % 8)) & 0x80) ? 0x0F : 0x00;
+	}
+
+	uint8_t byte = mask[row * stride + col / 2];
+
+	return (col & 0x01) ? (byte & 0x0F) : (byte >> 4);
+}
+
+static uint8_t get_pixel_alpha(uint8_t *image_src, uint8_t *mask, st7735_mask_bpp_t mask_bpp, uint16_t key_color,
+                               uint8_t width, uint8_t row, uint8_t col)
+{
+	if (mask == NULL)
+	{
+		uint8_t *pixel = &image_src[(row * width + col) * 2];
+		return ((pixel[0] != (key_color >> 8)) || (pixel[1] != (key_color & 0xFF))) ? 0x0F : 0x00;
+	}
+
+	uint16_t stride = (mask_bpp == ST7735_MASK_1BPP) ? (width + 7) / 8 : (width + 1) / 2;
+
+	return get_mask_alpha(mask, mask_bpp, stride, row, col);
+}
+
+typedef enum {
+	PIXEL_SKIP = 0,
+	PIXEL_OPAQUE,
+	PIXEL_BLEND,
+} pixel_class_t;
+
+static pixel_class_t classify_alpha(uint8_t alpha, bool blend)
+{
+	if (alpha == 0x0F)
+	{
+		return PIXEL_OPAQUE;
+	}
+
+	if (blend && alpha)
+	{
+		return PIXEL_BLEND;
+	}
+
+	/* Without read-back there is no background, threshold partial alpha */
+	return (alpha >= 0x08) ? PIXEL_OPAQUE : PIXEL_SKIP;
+}
+
+static err_code_t blend_run(st7735_handle_t handle, uint8_t x, uint8_t y, uint8_t *image_src, uint8_t *mask,
+                            st7735_mask_bpp_t mask_bpp, uint8_t width, uint8_t row, uint8_t col, uint8_t len)
+{
+	uint16_t bg[ST7735_TX_BUF_LEN / 3];
+	uint8_t *data = handle->tx_buf;
+
+	while (len)
+	{
+		uint8_t chunk = (len > ST7735_TX_BUF_LEN / 3) ? ST7735_TX_BUF_LEN / 3 : len;
+		uint16_t data_len = 0;
+
+		if (read_pixels(handle, x, y, x + chunk - 1, y, bg))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		for (uint8_t idx = 0; idx < chunk; idx++)
+		{
+			uint8_t *pixel = &image_src[(row * width + col + idx) * 2];
+			uint8_t alpha = get_pixel_alpha(image_src, mask, mask_bpp, 0, width, row, col + idx);
+			data_len += encode_color(handle, &data[data_len], st7735_blend_color((pixel[0] << 8) | pixel[1], bg[idx], alpha, 0x0F));
+		}
+
+		if (set_addr(handle, x, y, x + chunk - 1, y) || st7735_write_data(handle, data, data_len))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		x += chunk;
+		col += chunk;
+		len -= chunk;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t draw_image_runs(st7735_handle_t handle, int16_t x_origin, int16_t y_origin, uint8_t width, uint8_t height,
+                                  uint8_t *image_src, uint8_t *mask, st7735_mask_bpp_t mask_bpp, uint16_t key_color)
+{
+	bool blend = (mask != NULL) && (mask_bpp == ST7735_MASK_4BPP) && can_read(handle);
+	clip_rect_t area;
+
+	if (!clip_rect(handle, x_origin, y_origin, width, height, &area))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	/* Runs are found within the visible columns of the visible rows */
+	x_origin += handle->view.origin_x;
+	y_origin += handle->view.origin_y;
+	uint8_t col_end = area.x1 - x_origin;
+
+	for (uint8_t row = area.y0 - y_origin; row < area.y1 - y_origin; row++)
+	{
+		uint8_t col = area.x0 - x_origin;
+		while (col < col_end)
+		{
+			pixel_class_t run_class = classify_alpha(get_pixel_alpha(image_src, mask, mask_bpp, key_color, width, row, col), blend);
+			uint8_t run_start = col;
+
+			while ((col < col_end) &&
+			        (classify_alpha(get_pixel_alpha(image_src, mask, mask_bpp, key_color, width, row, col), blend) == run_class))
+			{
+				col++;
+			}
+
+			/* Transparent runs only move the address window */
+			if (run_class == PIXEL_OPAQUE)
+			{
+				if (set_addr(handle, x_origin + run_start, y_origin + row, x_origin + col - 1, y_origin + row) ||
+				        write_pixels(handle, &image_src[(row * width + run_start) * 2], ST7735_PIXEL_FORMAT_RGB565_BE, col - run_start))
+				{
+					return ERR_CODE_FAIL;
+				}
+			}
+			else if (run_class == PIXEL_BLEND)
+			{
+				if (blend_run(handle, x_origin + run_start, y_origin + row, image_src, mask, mask_bpp, width, row, run_start, col - run_start))
+				{
+					return ERR_CODE_FAIL;
+				}
+			}
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t write_stream(st7735_handle_t handle, const uint8_t *src, st7735_pixel_format_t format, uint32_t num_pixel)
+{
+	const clip_rect_t *visible = &handle->stream_clip;
+	uint8_t pixel_size = get_pixel_size(format);
+
+	/* Caller supplies the whole window, pixels outside the clip rectangle are dropped */
+	while (num_pixel)
+	{
+		uint16_t run = handle->stream_width - handle->stream_col;
+		if (run > num_pixel)
+		{
+			run = num_pixel;
+		}
+
+		if ((handle->stream_row >= visible->y0) && (handle->stream_row < visible->y1))
+		{
+			int16_t start = (handle->stream_col > visible->x0) ? handle->stream_col : visible->x0;
+			int16_t end = (handle->stream_col + run < visible->x1) ? handle->stream_col + run : visible->x1;
+
+			if ((start < end) && write_pixels(handle, src + (start - handle->stream_col) * pixel_size, format, end - start))
+			{
+				return ERR_CODE_FAIL;
+			}
+		}
+
+		src += run * pixel_size;
+		num_pixel -= run;
+		handle->stream_col += run;
+
+		if (handle->stream_col == handle->stream_width)
+		{
+			handle->stream_col = 0;
+			handle->stream_row++;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t push_view(st7735_handle_t handle, int16_t x, int16_t y, uint16_t width, uint16_t height, bool viewport)
+{
+	if (handle->view_depth >= ST7735_CLIP_STACK_DEPTH)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->view_stack[handle->view_depth++] = handle->view;
+
+	/* An empty intersection is kept as an empty rectangle that rejects everything */
+	clip_rect_t area;
+	if (!clip_rect(handle, x, y, width, height, &area))
+	{
+		area.x1 = area.x0;
+		area.y1 = area.y0;
+	}
+
+	if (viewport)
+	{
+		handle->view.origin_x += x;
+		handle->view.origin_y += y;
+	}
+
+	handle->view.clip = area;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t pop_view(st7735_handle_t handle)
+{
+	if (handle->view_depth == 0)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->view = handle->view_stack[--handle->view_depth];
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t fill_view(st7735_handle_t handle, uint16_t color)
+{
+	const clip_rect_t *clip = &handle->view.clip;
+
+	if ((clip->x0 >= clip->x1) || (clip->y0 >= clip->y1))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	return fill_area(handle, clip, color);
+}
+
+static err_code_t execute_cmd(st7735_handle_t handle, st7735_cmd_t *cmd)
+{
+	switch (cmd->type)
+	{
+	case ST7735_CMD_FILL:
+		return fill_view(handle, cmd->color);
+
+	case ST7735_CMD_FILL_RECT:
+		return fill_rect(handle, cmd->x, cmd->y, cmd->width, cmd->height, cmd->color);
+
+	case ST7735_CMD_PIXEL:
+		return draw_pixel(handle, cmd->x, cmd->y, cmd->color);
+
+	case ST7735_CMD_LINE:
+		return draw_line(handle, cmd->x, cmd->y, cmd->width, cmd->height, cmd->color);
+
+	case ST7735_CMD_RECTANGLE:
+		return draw_rectangle(handle, cmd->x, cmd->y, cmd->width, cmd->height, cmd->color);
+
+	case ST7735_CMD_CIRCLE:
+		return draw_circle(handle, cmd->x, cmd->y, cmd->width, cmd->color);
+
+	case ST7735_CMD_IMAGE:
+		return draw_image(handle, cmd->x, cmd->y, cmd->width, cmd->height, cmd->image, (st7735_pixel_format_t)cmd->param);
+
+	case ST7735_CMD_IMAGE_TRANSPARENT:
+		return draw_image_runs(handle, cmd->x, cmd->y, cmd->width, cmd->height, (uint8_t *)cmd->image, NULL, ST7735_MASK_1BPP, cmd->color);
+
+	case ST7735_CMD_IMAGE_MASKED:
+		return draw_image_runs(handle, cmd->x, cmd->y, cmd->width, cmd->height, (uint8_t *)cmd->image, (uint8_t *)cmd->mask,
+		                       (st7735_mask_bpp_t)cmd->param, 0);
+
+	case ST7735_CMD_TEXT:
+		for (uint8_t idx = 0; (idx < ST7735_QUEUE_TEXT_LEN) && cmd->text[idx]; idx++)
+		{
+			if (write_char(handle, (font_size_t)cmd->param, cmd->text[idx], cmd->color))
+			{
+				return ERR_CODE_FAIL;
+			}
+		}
+		return ERR_CODE_SUCCESS;
+
+	case ST7735_CMD_TEXT_BG:
+		for (uint8_t idx = 0; (idx < ST7735_QUEUE_TEXT_LEN) && cmd->text[idx]; idx++)
+		{
+			if (write_char_bg(handle, (font_size_t)cmd->param, cmd->text[idx], cmd->color, cmd->bg_color))
+			{
+				return ERR_CODE_FAIL;
+			}
+		}
+		return ERR_CODE_SUCCESS;
+
+	case ST7735_CMD_SET_POSITION:
+		handle->pos_x = cmd->x;
+		handle->pos_y = cmd->y;
+		return ERR_CODE_SUCCESS;
+
+	case ST7735_CMD_SET_COLOR_MODE:
+		return set_color_mode(handle, (st7735_color_mode_t)cmd->param);
+
+	case ST7735_CMD_PUSH_CLIP:
+		return push_view(handle, cmd->clip.x, cmd->clip.y, cmd->clip.width, cmd->clip.height, cmd->param);
+
+	case ST7735_CMD_POP_CLIP:
+		return pop_view(handle);
+
+	default:
+		return ERR_CODE_FAIL;
+	}
+}
+
+static bool cmd_is_drawing(st7735_cmd_t *cmd)
+{
+	return (cmd->type != ST7735_CMD_TEXT) && (cmd->type != ST7735_CMD_TEXT_BG) &&
+	       (cmd->type != ST7735_CMD_SET_POSITION) && (cmd->type != ST7735_CMD_SET_COLOR_MODE) &&
+	       (cmd->type != ST7735_CMD_PUSH_CLIP) && (cmd->type != ST7735_CMD_POP_CLIP);
+}
+
+static bool merge_fill_rect(st7735_cmd_t *dst, st7735_cmd_t *src)
+{
+	if ((dst->type != ST7735_CMD_FILL_RECT) || (src->type != ST7735_CMD_FILL_RECT) || (dst->color != src->color))
+	{
+		return false;
+	}
+
+	/* Horizontally adjacent spans with the same rows */
+	if ((dst->y == src->y) && (dst->height == src->height) && (src->x == dst->x + dst->width) &&
+	        (dst->width + src->width <= 0xFF))
+	{
+		dst->width += src->width;
+		return true;
+	}
+
+	/* Vertically adjacent spans with the same columns */
+	if ((dst->x == src->x) && (dst->width == src->width) && (src->y == dst->y + dst->height) &&
+	        (dst->height + src->height <= 0xFF))
+	{
+		dst->height += src->height;
+		return true;
+	}
+
+	return false;
+}
+
+static err_code_t execute_batch(st7735_handle_t handle, st7735_cmd_t *batch, uint16_t num_cmd)
+{
+	uint16_t first = 0;
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	/* Everything drawn before the last unclipped full screen fill is overdrawn */
+	uint8_t view_depth = handle->view_depth;
+	for (uint16_t idx = 0; idx < num_cmd; idx++)
+	{
+		if (batch[idx].type == ST7735_CMD_PUSH_CLIP)
+		{
+			view_depth++;
+		}
+		else if ((batch[idx].type == ST7735_CMD_POP_CLIP) && (view_depth > 0))
+		{
+			view_depth--;
+		}
+		else if ((batch[idx].type == ST7735_CMD_FILL) && (view_depth == 0))
+		{
+			first = idx;
+		}
+	}
+
+	/* Single pixels become 1x1 rectangles so neighbouring pixels merge into spans */
+	for (uint16_t idx = first; idx < num_cmd; idx++)
+	{
+		if (batch[idx].type == ST7735_CMD_PIXEL)
+		{
+			batch[idx].type = ST7735_CMD_FILL_RECT;
+			batch[idx].width = 1;
+			batch[idx].height = 1;
+		}
+	}
+
+	for (uint16_t idx = 0; idx < num_cmd; idx++)
+	{
+		if ((idx < first) && cmd_is_drawing(&batch[idx]))
+		{
+			continue;
+		}
+
+		while ((idx + 1 < num_cmd) && merge_fill_rect(&batch[idx], &batch[idx + 1]))
+		{
+			batch[idx + 1] = batch[idx];
+			idx++;
+		}
+
+		if (execute_cmd(handle, &batch[idx]))
+		{
+			err = ERR_CODE_FAIL;
+		}
+	}
+
+	return err;
+}
+
+#ifndef ST7735_STATIC_ONLY
+st7735_handle_t st7735_init(void)
+{
+	st7735_handle_t handle = calloc(1, sizeof(st7735_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+#endif
+
+size_t st7735_get_static_size(void)
+{
+	return ST7735_ARENA_ROUND(sizeof(st7735_t));
+}
+
+st7735_handle_t st7735_init_static(st7735_arena_t *arena)
+{
+	return st7735_arena_alloc(arena, sizeof(st7735_t));
+}
+
+err_code_t st7735_set_config(st7735_handle_t handle, st7735_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->width = config.width;
+	handle->height = config.height;
+	handle->set_cs = config.set_cs;
+	handle->set_dc = config.set_dc;
+	handle->set_rst = config.set_rst;
+	handle->set_bckl = config.set_bckl;
+	handle->spi_send = config.spi_send;
+	handle->delay = config.delay;
+	handle->user_data = config.user_data;
+	handle->set_cs_ctx = config.set_cs_ctx;
+	handle->set_dc_ctx = config.set_dc_ctx;
+	handle->spi_send_ctx = config.spi_send_ctx;
+	handle->set_rst_ctx = config.set_rst_ctx;
+	handle->set_bckl_ctx = config.set_bckl_ctx;
+	handle->delay_ctx = config.delay_ctx;
+	handle->spi_recv = config.spi_recv;
+	handle->spi_recv_ctx = config.spi_recv_ctx;
+	handle->lock = config.lock;
+	handle->unlock = config.unlock;
+	handle->color_mode = ST7735_COLOR_MODE_16BIT;
+	handle->pos_x = 0;
+	handle->pos_y = 0;
+	handle->view = (view_t) { 0, 0, { 0, 0, config.width, config.height } };
+	handle->view_depth = 0;
+	handle->tile_valid = false;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_config(st7735_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	if (st7735_reset(handle) || st7735_write_list_cmd(handle, init_cmds1) ||
+	        st7735_write_list_cmd(handle, init_cmds2) || st7735_write_list_cmd(handle, init_cmds3))
+	{
+		err = ERR_CODE_FAIL;
+	}
+	/* Init list selects 16-bit, restore the mode chosen before configuration */
+	else if ((handle->color_mode != ST7735_COLOR_MODE_16BIT) && set_color_mode(handle, handle->color_mode))
+	{
+		err = ERR_CODE_FAIL;
+	}
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_fill(st7735_handle_t handle, uint16_t color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_FILL, .color = color };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = fill_view(handle, color);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_fill_rect(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint16_t color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_FILL_RECT, .x = x_origin, .y = y_origin, .width = width, .height = height, .color = color };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = fill_rect(handle, x_origin, y_origin, width, height, color);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_draw_spans(st7735_handle_t handle, const st7735_span_t *spans, uint16_t num_span)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (spans == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		for (uint16_t idx = 0; idx < num_span; idx++)
+		{
+			st7735_cmd_t cmd = { .type = ST7735_CMD_FILL_RECT, .x = spans[idx].x, .y = spans[idx].y,
+			                     .width = spans[idx].len, .height = 1, .color = spans[idx].color };
+			if (st7735_queue_push(handle->queue, &cmd))
+			{
+				return ERR_CODE_FAIL;
+			}
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	for (uint16_t idx = 0; idx < num_span; idx++)
+	{
+		if (fill_rect(handle, spans[idx].x, spans[idx].y, spans[idx].len, 1, spans[idx].color))
+		{
+			err = ERR_CODE_FAIL;
+			break;
+		}
+	}
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_write_char(st7735_handle_t handle, font_size_t font_size, uint8_t chr, uint16_t color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_TEXT, .param = font_size, .color = color, .text = { chr } };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = write_char(handle, font_size, chr, color);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_write_string(st7735_handle_t handle, font_size_t font_size, uint8_t *str, uint16_t color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		while (*str)
+		{
+			st7735_cmd_t cmd = { .type = ST7735_CMD_TEXT, .param = font_size, .color = color };
+			for (uint8_t idx = 0; (idx < ST7735_QUEUE_TEXT_LEN) && *str; idx++)
+			{
+				cmd.text[idx] = *str++;
+			}
+
+			if (st7735_queue_push(handle->queue, &cmd))
+			{
+				return ERR_CODE_FAIL;
+			}
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	while (*str)
+	{
+		if (write_char(handle, font_size, *str, color))
+		{
+			err = ERR_CODE_FAIL;
+			break;
+		}
+		str++;
+	}
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_write_char_bg(st7735_handle_t handle, font_size_t font_size, uint8_t chr, uint16_t color, uint16_t bg_color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_TEXT_BG, .param = font_size, .color = color, .bg_color = bg_color, .text = { chr } };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = write_char_bg(handle, font_size, chr, color, bg_color);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_write_string_bg(st7735_handle_t handle, font_size_t font_size, uint8_t *str, uint16_t color, uint16_t bg_color)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (str == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		while (*str)
+		{
+			st7735_cmd_t cmd = { .type = ST7735_CMD_TEXT_BG, .param = font_size, .color = color, .bg_color = bg_color };
+			for (uint8_t idx = 0; (idx < ST7735_QUEUE_TEXT_LEN) && *str; idx++)
+			{
+				cmd.text[idx] = *str++;
+			}
+
+			if (st7735_queue_push(handle->queue, &cmd))
+			{
+				return ERR_CODE_FAIL;
+			}
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	while (*str)
+	{
+		if (write_char_bg(handle, font_size, *str, color, bg_color))
+		{
+			err = ERR_CODE_FAIL;
+			break;
+		}
+		str++;
+	}
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_draw_pixel(st7735_handle_t handle, uint8_t x, uint8_t y, uint16_t color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_PIXEL, .x = x, .y = y, .color = color };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = draw_pixel(handle, x, y, color);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_draw_line(st7735_handle_t handle, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint16_t color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_LINE, .x = x_start, .y = y_start, .width = x_end, .height = y_end, .color = color };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = draw_line(handle, x_start, y_start, x_end, y_end, color);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_draw_rectangle(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint16_t color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_RECTANGLE, .x = x_origin, .y = y_origin, .width = width, .height = height, .color = color };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = draw_rectangle(handle, x_origin, y_origin, width, height, color);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_draw_circle(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t radius, uint16_t color)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_CIRCLE, .x = x_origin, .y = y_origin, .width = radius, .color = color };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = draw_circle(handle, x_origin, y_origin, radius, color);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_draw_image(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_IMAGE, .param = ST7735_PIXEL_FORMAT_RGB565_BE, .x = x_origin, .y = y_origin,
+		                     .width = width, .height = height, .image = image_src };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err = draw_image(handle, x_origin, y_origin, width, height, image_src, ST7735_PIXEL_FORMAT_RGB565_BE);
+
+	st7735_deselect(handle);
+
+	return err;
+}
+
+err_code_t st7735_draw_image_format(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, const void *image_src, st7735_pixel_format_t format)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (image_src == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (format > ST7735_PIXEL_FORMAT_GRAY8)
+	{
+		return ERR_CODE_FAIL;
+	}
 
-	return ERR_CODE_SUCCESS;
-}
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_IMAGE, .param = format, .x = x_origin, .y = y_origin,
+		                     .width = width, .height = height, .image = image_src };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
 
-static err_code_t draw_pixel(st7735_handle_t handle, uint8_t x, uint8_t y, uint16_t color)
-{
-	set_addr(handle, x, y, x + 1, y + 1);
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
 
-	uint8_t data[2] = { color >> 8, color & 0xFF };
-	st7735_write_data(handle, data, 2);
+	err_code_t err = draw_image(handle, x_origin, y_origin, width, height, image_src, format);
 
-	return ERR_CODE_SUCCESS;
+	st7735_deselect(handle);
 
+	return err;
 }
 
-static err_code_t draw_line(st7735_handle_t handle, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint16_t color)
+err_code_t st7735_stream_begin(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height)
 {
-	int32_t deltaX = abs(x_end - x_start);
-	int32_t deltaY = abs(y_end - y_start);
-	int32_t signX = ((x_start < x_end) ? 1 : -1);
-	int32_t signY = ((y_start < y_end) ? 1 : -1);
-	int32_t error = deltaX - deltaY;
-	int32_t error2;
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
 
-	draw_pixel(handle, x_end, y_end, color);
+	/* A stream holds the bus across calls, which the render queue cannot express */
+	if ((handle->queue != NULL) || (width == 0) || (height == 0))
+	{
+		return ERR_CODE_FAIL;
+	}
 
-	while ((x_start != x_end) || (y_start != y_end))
+	if (st7735_select(handle))
 	{
-		draw_pixel(handle, x_start, y_start, color);
+		return ERR_CODE_FAIL;
+	}
 
-		error2 = error * 2;
-		if (error2 > -deltaY) {
-			error -= deltaY;
-			x_start += signX;
-		} else {
-			/*nothing to do*/
-		}
+	clip_rect_t area;
+	handle->stream_width = width;
+	handle->stream_col = 0;
+	handle->stream_row = 0;
+	handle->stream_clip = (clip_rect_t) { 0, 0, 0, 0 };
 
-		if (error2 < deltaX) {
-			error += deltaX;
-			y_start += signY;
-		} else {
-			/*nothing to do*/
+	if (clip_rect(handle, x_origin, y_origin, width, height, &area))
+	{
+		int16_t x = x_origin + handle->view.origin_x;
+		int16_t y = y_origin + handle->view.origin_y;
+		handle->stream_clip = (clip_rect_t) { area.x0 - x, area.y0 - y, area.x1 - x, area.y1 - y };
+		if (set_addr(handle, area.x0, area.y0, area.x1 - 1, area.y1 - 1))
+		{
+			st7735_deselect(handle);
+			return ERR_CODE_FAIL;
 		}
 	}
 
 	return ERR_CODE_SUCCESS;
 }
 
-st7735_handle_t st7735_init(void)
+err_code_t st7735_stream_write(st7735_handle_t handle, const void *src, st7735_pixel_format_t format, uint32_t num_pixel)
 {
-	st7735_handle_t handle = calloc(1, sizeof(st7735_t));
-	if (handle == NULL)
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (src == NULL))
 	{
-		return NULL;
+		return ERR_CODE_NULL_PTR;
 	}
 
-	return handle;
+	if (format > ST7735_PIXEL_FORMAT_GRAY8)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	return write_stream(handle, src, format, num_pixel);
 }
 
-err_code_t st7735_set_config(st7735_handle_t handle, st7735_cfg_t config)
+err_code_t st7735_stream_end(st7735_handle_t handle)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -397,48 +2179,51 @@ err_code_t st7735_set_config(st7735_handle_t handle, st7735_cfg_t config)
 		return ERR_CODE_NULL_PTR;
 	}
 
-	handle->width = config.width;
-	handle->height = config.height;
-	handle->set_cs = config.set_cs;
-	handle->set_dc = config.set_dc;
-	handle->set_rst = config.set_rst;
-	handle->set_bckl = config.set_bckl;
-	handle->spi_send = config.spi_send;
-	handle->delay = config.delay;
-	handle->pos_x = 0;
-	handle->pos_y = 0;
+	st7735_deselect(handle);
 
 	return ERR_CODE_SUCCESS;
 }
 
-err_code_t st7735_config(st7735_handle_t handle)
+err_code_t st7735_present_frame(st7735_handle_t handle, const uint8_t *frame, uint16_t *num_rect)
 {
 	/* Check if handle structure is NULL */
-	if (handle == NULL)
+	if ((handle == NULL) || (frame == NULL))
 	{
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	/* Tile hashes are producer state, the frame is compared and sent in one call */
+	if (handle->queue != NULL)
 	{
-		handle->set_cs(0);
+		return ERR_CODE_FAIL;
+	}
+
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
 	}
 
-	st7735_reset(handle);
+	err_code_t err = present_frame(handle, frame, num_rect);
 
-	st7735_write_list_cmd(handle, init_cmds1);
-	st7735_write_list_cmd(handle, init_cmds2);
-	st7735_write_list_cmd(handle, init_cmds3);
+	st7735_deselect(handle);
 
-	if (handle->set_cs != NULL)
+	return err;
+}
+
+err_code_t st7735_invalidate_frame(st7735_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
 	{
-		handle->set_cs(1);
+		return ERR_CODE_NULL_PTR;
 	}
 
+	handle->tile_valid = false;
+
 	return ERR_CODE_SUCCESS;
 }
 
-err_code_t st7735_fill(st7735_handle_t handle, uint16_t color)
+err_code_t st7735_set_color_mode(st7735_handle_t handle, st7735_color_mode_t color_mode)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -446,166 +2231,198 @@ err_code_t st7735_fill(st7735_handle_t handle, uint16_t color)
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	if ((color_mode != ST7735_COLOR_MODE_16BIT) && (color_mode != ST7735_COLOR_MODE_18BIT))
 	{
-		handle->set_cs(0);
+		return ERR_CODE_FAIL;
 	}
 
-	set_addr(handle, 0, 0, handle->width - 1, handle->height - 1);
-
-	uint8_t data[2] = { color >> 8, color & 0xFF };
-	for (uint8_t heigt_idx = 0; heigt_idx < handle->height; heigt_idx++)
+	if (handle->queue != NULL)
 	{
-		for (uint8_t width_idx = 0; width_idx < handle->width; width_idx++)
-		{
-			st7735_write_data(handle, data, 2);
-		}
+		st7735_cmd_t cmd = { .type = ST7735_CMD_SET_COLOR_MODE, .param = color_mode };
+		return st7735_queue_push(handle->queue, &cmd);
 	}
 
-	if (handle->set_cs != NULL)
+	if (st7735_select(handle))
 	{
-		handle->set_cs(1);
+		return ERR_CODE_FAIL;
 	}
 
-	return ERR_CODE_SUCCESS;
+	err_code_t err = set_color_mode(handle, color_mode);
+
+	st7735_deselect(handle);
+
+	return err;
 }
 
-err_code_t st7735_write_char(st7735_handle_t handle, font_size_t font_size, uint8_t chr, uint16_t color)
+err_code_t st7735_get_color_mode(st7735_handle_t handle, st7735_color_mode_t *color_mode)
 {
 	/* Check if handle structure is NULL */
-	if (handle == NULL)
+	if ((handle == NULL) || (color_mode == NULL))
 	{
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	*color_mode = handle->color_mode;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_get_glyph(font_size_t font_size, uint8_t chr, st7735_glyph_t *glyph)
+{
+	/* Check if handle structure is NULL */
+	if (glyph == NULL)
 	{
-		handle->set_cs(0);
+		return ERR_CODE_NULL_PTR;
 	}
 
 	font_t font;
 	get_font(chr, font_size, &font);
 
-	uint8_t num_byte_per_row = font.data_len / font.height;
-	for (uint8_t height_idx = 0; height_idx < font.height; height_idx ++)
+	glyph->data = font.data;
+	glyph->stride = font.data_len / font.height;
+	glyph->advance = font.width + glyph->stride;
+	glyph->height = font.height;
+
+	return ERR_CODE_SUCCESS;
+}
+
+uint16_t st7735_blend_color(uint16_t fg, uint16_t bg, uint8_t alpha, uint8_t max_alpha)
+{
+	if (max_alpha == 0)
+	{
+		return bg;
+	}
+
+	uint8_t inv = max_alpha - alpha;
+	uint16_t r = (((fg >> 11) & 0x1F) * alpha + ((bg >> 11) & 0x1F) * inv) / max_alpha;
+	uint16_t g = (((fg >> 5) & 0x3F) * alpha + ((bg >> 5) & 0x3F) * inv) / max_alpha;
+	uint16_t b = ((fg & 0x1F) * alpha + (bg & 0x1F) * inv) / max_alpha;
+
+	return (r << 11) | (g << 5) | b;
+}
+
+err_code_t st7735_draw_image_transparent(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src, uint16_t key_color)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (image_src == NULL))
 	{
-		for ( uint8_t byte_idx = 0; byte_idx < num_byte_per_row; byte_idx++)
-		{
-			for (uint8_t width_idx = 0; width_idx < 8; width_idx++)
-			{
-				uint8_t x = handle->pos_x + width_idx + byte_idx * 8;
-				uint8_t y = handle->pos_y + height_idx;
-				if (((font.data[height_idx * num_byte_per_row + byte_idx] << width_idx) & 0x80) == 0x80)
-				{
-					draw_pixel(handle, x, y, color);
-				}
-			}
-		}
+		return ERR_CODE_NULL_PTR;
 	}
 
-	handle->pos_x += font.width + num_byte_per_row;
+	if (handle->queue != NULL)
+	{
+		st7735_cmd_t cmd = { .type = ST7735_CMD_IMAGE_TRANSPARENT, .color = key_color, .x = x_origin, .y = y_origin,
+		                     .width = width, .height = height, .image = image_src };
+		return st7735_queue_push(handle->queue, &cmd);
+	}
 
-	if (handle->set_cs != NULL)
+	if (st7735_select(handle))
 	{
-		handle->set_cs(1);
+		return ERR_CODE_FAIL;
 	}
 
-	return ERR_CODE_SUCCESS;
+	err_code_t err = draw_image_runs(handle, x_origin, y_origin, width, height, image_src, NULL, ST7735_MASK_1BPP, key_color);
+
+	st7735_deselect(handle);
+
+	return err;
 }
 
-err_code_t st7735_write_string(st7735_handle_t handle, font_size_t font_size, uint8_t *str, uint16_t color)
+err_code_t st7735_draw_image_masked(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src, uint8_t *mask, st7735_mask_bpp_t mask_bpp)
 {
 	/* Check if handle structure is NULL */
-	if (handle == NULL)
+	if ((handle == NULL) || (image_src == NULL) || (mask == NULL))
 	{
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	if ((mask_bpp != ST7735_MASK_1BPP) && (mask_bpp != ST7735_MASK_4BPP))
 	{
-		handle->set_cs(0);
+		return ERR_CODE_FAIL;
 	}
 
-	while (*str)
+	if (handle->queue != NULL)
 	{
-		font_t font;
-		get_font(*str, font_size, &font);
-
-		uint8_t num_byte_per_row = font.data_len / font.height;
-		for (uint8_t height_idx = 0; height_idx < font.height; height_idx ++)
-		{
-			for ( uint8_t byte_idx = 0; byte_idx < num_byte_per_row; byte_idx++)
-			{
-				for (uint8_t width_idx = 0; width_idx < 8; width_idx++)
-				{
-					uint8_t x = handle->pos_x + width_idx + byte_idx * 8;
-					uint8_t y = handle->pos_y + height_idx;
-					if (((font.data[height_idx * num_byte_per_row + byte_idx] << width_idx) & 0x80) == 0x80)
-					{
-						draw_pixel(handle, x, y, color);
-					}
-				}
-			}
-		}
-		handle->pos_x += font.width + num_byte_per_row;
-		str++;
+		st7735_cmd_t cmd = { .type = ST7735_CMD_IMAGE_MASKED, .param = mask_bpp, .x = x_origin, .y = y_origin,
+		                     .width = width, .height = height, .image = image_src, .mask = mask };
+		return st7735_queue_push(handle->queue, &cmd);
 	}
 
-	if (handle->set_cs != NULL)
+	if (st7735_select(handle))
 	{
-		handle->set_cs(1);
+		return ERR_CODE_FAIL;
 	}
 
-	return ERR_CODE_SUCCESS;
+	err_code_t err = draw_image_runs(handle, x_origin, y_origin, width, height, image_src, mask, mask_bpp, 0);
+
+	st7735_deselect(handle);
+
+	return err;
 }
 
-err_code_t st7735_draw_pixel(st7735_handle_t handle, uint8_t x, uint8_t y, uint16_t color)
+err_code_t st7735_read_image(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint16_t *buf)
 {
 	/* Check if handle structure is NULL */
-	if (handle == NULL)
+	if ((handle == NULL) || (buf == NULL))
 	{
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	/* Reading drives the bus directly and would race the render worker */
+	if ((handle->queue != NULL) || !can_read(handle) || (width == 0) || (height == 0))
 	{
-		handle->set_cs(0);
+		return ERR_CODE_FAIL;
 	}
 
-	draw_pixel(handle, x, y, color);
-
-	if (handle->set_cs != NULL)
+	if (st7735_select(handle))
 	{
-		handle->set_cs(1);
+		return ERR_CODE_FAIL;
 	}
 
-	return ERR_CODE_SUCCESS;
+	err_code_t err = read_pixels(handle, x_origin, y_origin, x_origin + width - 1, y_origin + height - 1, buf);
+
+	st7735_deselect(handle);
+
+	return err;
 }
 
-err_code_t st7735_draw_line(st7735_handle_t handle, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint16_t color)
+err_code_t st7735_read_id(st7735_handle_t handle, uint8_t *id)
 {
 	/* Check if handle structure is NULL */
-	if (handle == NULL)
+	if ((handle == NULL) || (id == NULL))
 	{
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	/* Reading drives the bus directly and would race the render worker */
+	if ((handle->queue != NULL) || !can_read(handle))
 	{
-		handle->set_cs(0);
+		return ERR_CODE_FAIL;
 	}
 
-	draw_line(handle, x_start, y_start, x_end, y_end, color);
+	if (st7735_select(handle))
+	{
+		return ERR_CODE_FAIL;
+	}
 
-	if (handle->set_cs != NULL)
+	uint8_t reg[3] = { ST7735_RDID1, ST7735_RDID2, ST7735_RDID3 };
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	for (uint8_t idx = 0; idx < 3; idx++)
 	{
-		handle->set_cs(1);
+		if (st7735_write_cmd(handle, reg[idx]) || st7735_read_data(handle, &id[idx], 1))
+		{
+			err = ERR_CODE_FAIL;
+			break;
+		}
 	}
 
-	return ERR_CODE_SUCCESS;
+	st7735_deselect(handle);
+
+	return err;
 }
 
-err_code_t st7735_draw_rectangle(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint16_t color)
+err_code_t st7735_set_position(st7735_handle_t handle, uint8_t x, uint8_t y)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -613,25 +2430,19 @@ err_code_t st7735_draw_rectangle(st7735_handle_t handle, uint8_t x_origin, uint8
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	if (handle->queue != NULL)
 	{
-		handle->set_cs(0);
+		st7735_cmd_t cmd = { .type = ST7735_CMD_SET_POSITION, .x = x, .y = y };
+		return st7735_queue_push(handle->queue, &cmd);
 	}
 
-	draw_line(handle, x_origin, y_origin, x_origin + width, y_origin, color);
-	draw_line(handle, x_origin + width, y_origin, x_origin + width, y_origin + height, color);
-	draw_line(handle, x_origin + width, y_origin + height, x_origin, y_origin + height, color);
-	draw_line(handle, x_origin, y_origin + height, x_origin, y_origin, color);
-
-	if (handle->set_cs != NULL)
-	{
-		handle->set_cs(1);
-	}
+	handle->pos_x = x;
+	handle->pos_y = y;
 
 	return ERR_CODE_SUCCESS;
 }
 
-err_code_t st7735_draw_circle(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t radius, uint16_t color)
+err_code_t st7735_push_clip(st7735_handle_t handle, st7735_rect_t rect)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -639,53 +2450,35 @@ err_code_t st7735_draw_circle(st7735_handle_t handle, uint8_t x_origin, uint8_t
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	if (handle->queue != NULL)
 	{
-		handle->set_cs(0);
+		st7735_cmd_t cmd = { .type = ST7735_CMD_PUSH_CLIP, .param = false,
+		                     .clip = { rect.x, rect.y, rect.width, rect.height } };
+		return st7735_queue_push(handle->queue, &cmd);
 	}
 
-	int32_t x = -radius;
-	int32_t y = 0;
-	int32_t err = 2 - 2 * radius;
-	int32_t e2;
-
-	do {
-		draw_pixel(handle, x_origin - x, y_origin + y, color);
-		draw_pixel(handle, x_origin + x, y_origin + y, color);
-		draw_pixel(handle, x_origin + x, y_origin - y, color);
-		draw_pixel(handle, x_origin - x, y_origin - y, color);
-
-		e2 = err;
-		if (e2 <= y) {
-			y++;
-			err = err + (y * 2 + 1);
-			if (-x == y && e2 <= x) {
-				e2 = 0;
-			}
-			else {
-				/*nothing to do*/
-			}
-		} else {
-			/*nothing to do*/
-		}
+	return push_view(handle, rect.x, rect.y, rect.width, rect.height, false);
+}
 
-		if (e2 > x) {
-			x++;
-			err = err + (x * 2 + 1);
-		} else {
-			/*nothing to do*/
-		}
-	} while (x <= 0);
+err_code_t st7735_push_viewport(st7735_handle_t handle, st7735_rect_t rect)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
 
-	if (handle->set_cs != NULL)
+	if (handle->queue != NULL)
 	{
-		handle->set_cs(1);
+		st7735_cmd_t cmd = { .type = ST7735_CMD_PUSH_CLIP, .param = true,
+		                     .clip = { rect.x, rect.y, rect.width, rect.height } };
+		return st7735_queue_push(handle->queue, &cmd);
 	}
 
-	return ERR_CODE_SUCCESS;
+	return push_view(handle, rect.x, rect.y, rect.width, rect.height, true);
 }
 
-err_code_t st7735_draw_image(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src)
+err_code_t st7735_pop_clip(st7735_handle_t handle)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -693,37 +2486,42 @@ err_code_t st7735_draw_image(st7735_handle_t handle, uint8_t x_origin, uint8_t y
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_cs != NULL)
+	if (handle->queue != NULL)
 	{
-		handle->set_cs(0);
+		st7735_cmd_t cmd = { .type = ST7735_CMD_POP_CLIP };
+		return st7735_queue_push(handle->queue, &cmd);
 	}
 
-	set_addr(handle, x_origin, y_origin, x_origin + width - 1, y_origin + height - 1);
-	st7735_write_data(handle, image_src, width * height * 2);
+	return pop_view(handle);
+}
 
-	if (handle->set_cs != NULL)
+err_code_t st7735_set_queue(st7735_handle_t handle, st7735_queue_handle_t queue)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
 	{
-		handle->set_cs(1);
+		return ERR_CODE_NULL_PTR;
 	}
 
+	handle->queue = queue;
+
 	return ERR_CODE_SUCCESS;
 }
 
-err_code_t st7735_set_position(st7735_handle_t handle, uint8_t x, uint8_t y)
+err_code_t st7735_get_queue(st7735_handle_t handle, st7735_queue_handle_t *queue)
 {
 	/* Check if handle structure is NULL */
-	if (handle == NULL)
+	if ((handle == NULL) || (queue == NULL))
 	{
 		return ERR_CODE_NULL_PTR;
 	}
 
-	handle->pos_x = x;
-	handle->pos_y = y;
+	*queue = handle->queue;
 
 	return ERR_CODE_SUCCESS;
 }
 
-err_code_t st7735_get_position(st7735_handle_t handle, uint8_t *x, uint8_t *y)
+err_code_t st7735_set_trace(st7735_handle_t handle, st7735_trace_handle_t trace)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -731,13 +2529,57 @@ err_code_t st7735_get_position(st7735_handle_t handle, uint8_t *x, uint8_t *y)
 		return ERR_CODE_NULL_PTR;
 	}
 
-	*x = handle->pos_x;
-	*y = handle->pos_y;
+	handle->trace = trace;
 
 	return ERR_CODE_SUCCESS;
 }
 
-err_code_t st7735_set_bckl_on(st7735_handle_t handle)
+err_code_t st7735_process_queue(st7735_handle_t handle, uint16_t *num_cmd)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->queue == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	st7735_cmd_t batch[ST7735_QUEUE_BATCH];
+	uint16_t num_batch;
+	uint16_t total = 0;
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	do {
+		/* Bus is taken before popping, so a failed select leaves the commands queued */
+		if (st7735_select(handle))
+		{
+			err = ERR_CODE_FAIL;
+			break;
+		}
+
+		num_batch = 0;
+		while ((num_batch < ST7735_QUEUE_BATCH) && (st7735_queue_pop(handle->queue, &batch[num_batch]) == ERR_CODE_SUCCESS))
+		{
+			num_batch++;
+		}
+
+		if (num_batch && execute_batch(handle, batch, num_batch))
+		{
+			err = ERR_CODE_FAIL;
+		}
+
+		st7735_deselect(handle);
+
+		total += num_batch;
+	} while (num_batch == ST7735_QUEUE_BATCH);
+
+	if (num_cmd != NULL)
+	{
+		*num_cmd = total;
+	}
+
+	return err;
+}
+
+err_code_t st7735_get_position(st7735_handle_t handle, uint8_t *x, uint8_t *y)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -745,15 +2587,19 @@ err_code_t st7735_set_bckl_on(st7735_handle_t handle)
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_bckl != NULL)
+	/* Position is worker state and lags the commands still queued */
+	if (handle->queue != NULL)
 	{
-		handle->set_bckl(1);
+		return ERR_CODE_FAIL;
 	}
 
+	*x = handle->pos_x;
+	*y = handle->pos_y;
+
 	return ERR_CODE_SUCCESS;
 }
 
-err_code_t st7735_set_bckl_off(st7735_handle_t handle)
+err_code_t st7735_set_bckl_on(st7735_handle_t handle)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -761,10 +2607,16 @@ err_code_t st7735_set_bckl_off(st7735_handle_t handle)
 		return ERR_CODE_NULL_PTR;
 	}
 
-	if (handle->set_bckl != NULL)
+	return st7735_set_bckl(handle, 1);
+}
+
+err_code_t st7735_set_bckl_off(st7735_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
 	{
-		handle->set_bckl(0);
+		return ERR_CODE_NULL_PTR;
 	}
 
-	return ERR_CODE_SUCCESS;
+	return st7735_set_bckl(handle, 0);
 }
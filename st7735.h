@@ -29,16 +29,89 @@ extern "C" {
 
 #include "err_code.h"
 #include "fonts.h"
+#include "st7735_arena.h"
+#include "st7735_queue.h"
+#include "st7735_trace.h"
+
+#define ST7735_CLIP_STACK_DEPTH 		8		/*!< Nested clip rectangles and viewports */
 
 typedef err_code_t (*st7735_func_set_gpio)(uint8_t level);
 typedef err_code_t (*st7735_func_spi_send)(uint8_t *buf_send, uint16_t len);
 typedef void (*st7735_func_delay)(uint32_t time_ms);
+typedef err_code_t (*st7735_func_set_gpio_ctx)(void *user_data, uint8_t level);
+typedef err_code_t (*st7735_func_spi_send_ctx)(void *user_data, uint8_t *buf_send, uint16_t len);
+typedef void (*st7735_func_delay_ctx)(void *user_data, uint32_t time_ms);
+typedef err_code_t (*st7735_func_spi_recv)(uint8_t *buf_recv, uint16_t len);
+typedef err_code_t (*st7735_func_spi_recv_ctx)(void *user_data, uint8_t *buf_recv, uint16_t len);
+typedef err_code_t (*st7735_func_lock)(void *user_data);
+typedef err_code_t (*st7735_func_unlock)(void *user_data);
 
 /**
  * @brief   Handle structure.
  */
 typedef struct st7735 *st7735_handle_t;
 
+/**
+ * @brief   Alpha mask format used by sprite blits.
+ */
+typedef enum {
+	ST7735_MASK_1BPP = 1,					/*!< 1 bit per pixel, MSB first, rows padded to byte */
+	ST7735_MASK_4BPP = 4,					/*!< 4 bits per pixel, high nibble first, rows padded to byte */
+} st7735_mask_bpp_t;
+
+/**
+ * @brief   Source pixel format accepted by st7735_draw_image_format.
+ */
+typedef enum {
+	ST7735_PIXEL_FORMAT_RGB565 = 0,			/*!< RGB565 as native-endian uint16_t */
+	ST7735_PIXEL_FORMAT_RGB565_BE,			/*!< RGB565 as big-endian byte pairs, format of st7735_draw_image */
+	ST7735_PIXEL_FORMAT_RGB888,				/*!< 3 bytes per pixel in R, G, B order */
+	ST7735_PIXEL_FORMAT_ARGB8888,			/*!< 0xAARRGGBB as native-endian uint32_t, alpha is ignored */
+	ST7735_PIXEL_FORMAT_GRAY8,				/*!< 1 byte per pixel luminance */
+} st7735_pixel_format_t;
+
+/**
+ * @brief   Interface pixel format (COLMOD).
+ */
+typedef enum {
+	ST7735_COLOR_MODE_16BIT = 0x05,			/*!< 16-bit RGB565, 2 bytes per pixel */
+	ST7735_COLOR_MODE_18BIT = 0x06,			/*!< 18-bit RGB666, 3 bytes per pixel */
+} st7735_color_mode_t;
+
+/**
+ * @brief   Rectangle.
+ */
+typedef struct {
+	int16_t 				x;				/*!< x origin position */
+	int16_t 				y;				/*!< y origin position */
+	uint16_t 				width;			/*!< Width */
+	uint16_t 				height;			/*!< Height */
+} st7735_rect_t;
+
+/**
+ * @brief   Horizontal span of one color.
+ */
+typedef struct {
+	uint8_t 				x;				/*!< x start position */
+	uint8_t 				y;				/*!< Row index */
+	uint8_t 				len;			/*!< Length in pixel */
+	uint16_t 				color;			/*!< Color */
+} st7735_span_t;
+
+/**
+ * @brief   Bitmap glyph of the fonts library, as drawn by st7735_write_char.
+ */
+typedef struct {
+	const uint8_t 			*data;			/*!< Rows of stride bytes, MSB first */
+	uint8_t 				stride;			/*!< Bytes per row */
+	uint8_t 				advance;		/*!< Pen advance in pixel */
+	uint8_t 				height;			/*!< Height in pixel */
+} st7735_glyph_t;
+
+/*!< True if the glyph pixel at row, col is set. Columns past the bitmap are clear */
+#define ST7735_GLYPH_PIXEL(glyph, row, col) 	(((col) < (glyph)->stride * 8) && \
+		(((glyph)->data[(row) * (glyph)->stride + (col) / 8] << ((col) % 8)) & 0x80))
+
 /**
  * @brief   Configuration structure.
  */
@@ -50,7 +123,18 @@ typedef struct {
 	st7735_func_set_gpio 	set_rst;		/*!< Function set RST. Used in SPI mode */
 	st7735_func_set_gpio    set_bckl;       /*!< Function on/off LED backlight */
 	st7735_func_spi_send 	spi_send;		/*!< Function send SPI data */
-	st7735_func_delay 		delay; 			/*!< Function delay */
+	st7735_func_delay 		delay; 			/*!< Function delay. Init delays are skipped if neither delay nor delay_ctx is set */
+	void 					*user_data;		/*!< User context passed to context callbacks and lock hooks */
+	st7735_func_set_gpio_ctx set_cs_ctx; 	/*!< Function set CS with user context. Overrides set_cs if not NULL */
+	st7735_func_set_gpio_ctx set_dc_ctx; 	/*!< Function set DC with user context. Overrides set_dc if not NULL */
+	st7735_func_spi_send_ctx spi_send_ctx; 	/*!< Function send SPI data with user context. Overrides spi_send if not NULL */
+	st7735_func_set_gpio_ctx set_rst_ctx; 	/*!< Function set RST with user context. Overrides set_rst if not NULL */
+	st7735_func_set_gpio_ctx set_bckl_ctx; 	/*!< Function on/off LED backlight with user context. Overrides set_bckl if not NULL */
+	st7735_func_delay_ctx 	delay_ctx; 		/*!< Function delay with user context. Overrides delay if not NULL */
+	st7735_func_spi_recv 	spi_recv;		/*!< Function receive SPI data. Optional, enables GRAM and ID read-back */
+	st7735_func_spi_recv_ctx spi_recv_ctx; 	/*!< Function receive SPI data with user context. Overrides spi_recv if not NULL */
+	st7735_func_lock 		lock;			/*!< Function lock the bus before CS is asserted. Optional */
+	st7735_func_unlock 		unlock;			/*!< Function unlock the bus after CS is released. Optional */
 } st7735_cfg_t;
 
 /*
@@ -64,7 +148,33 @@ typedef struct {
  *      - Handle structure: Success.
  *      - Others:           Fail.
  */
+#ifndef ST7735_STATIC_ONLY
 st7735_handle_t st7735_init(void);
+#endif
+
+/*
+ * @brief   Get arena space needed by st7735_init_static.
+ *
+ * @param   None.
+ *
+ * @return  Size in bytes, rounded to ST7735_ARENA_ALIGN.
+ */
+size_t st7735_get_static_size(void);
+
+/*
+ * @brief   Initialize ST7735 with handle storage carved from a work arena.
+ *
+ * @note    Same as st7735_init without touching the heap. The handle holds
+ *          the transmit buffer, so placing the arena in DMA-capable RAM
+ *          keeps every converted pixel burst there.
+ *
+ * @param   arena Work arena.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail, arena exhausted.
+ */
+st7735_handle_t st7735_init_static(st7735_arena_t *arena);
 
 /*
  * @brief   Set configuration parameters.
@@ -90,7 +200,7 @@ err_code_t st7735_set_config(st7735_handle_t handle, st7735_cfg_t config);
 err_code_t st7735_config(st7735_handle_t handle);
 
 /*
- * @brief   Fill screen.
+ * @brief   Fill screen, or the current clip rectangle if one is pushed.
  *
  * @param   handle Handle structure.
  * @param 	color Color.
@@ -101,6 +211,37 @@ err_code_t st7735_config(st7735_handle_t handle);
  */
 err_code_t st7735_fill(st7735_handle_t handle, uint16_t color);
 
+/*
+ * @brief   Fill rectangle.
+ *
+ * @param   handle Handle structure.
+ * @param 	x_origin x origin position.
+ * @param 	y_origin y origin position.
+ * @param 	width Width.
+ * @param 	height Height.
+ * @param 	color Color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_fill_rect(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint16_t color);
+
+/*
+ * @brief   Draw horizontal spans.
+ *
+ * @note    All spans are sent under one CS assertion, each as one burst.
+ *
+ * @param   handle Handle structure.
+ * @param 	spans Spans.
+ * @param 	num_span Number of spans.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_draw_spans(st7735_handle_t handle, const st7735_span_t *spans, uint16_t num_span);
+
 /*
  * @brief   Write character.
  *
@@ -129,6 +270,39 @@ err_code_t st7735_write_char(st7735_handle_t handle, font_size_t font_size, uint
  */
 err_code_t st7735_write_string(st7735_handle_t handle, font_size_t font_size, uint8_t *str, uint16_t color);
 
+/*
+ * @brief   Write character with opaque background.
+ *
+ * @note    The whole glyph cell, advance width by font height, is sent in
+ *          one address window, so the character replaces what was below it.
+ *
+ * @param   handle Handle structure.
+ * @param   font_size Font size.
+ * @param   chr Character.
+ * @param 	color Color.
+ * @param 	bg_color Background color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_write_char_bg(st7735_handle_t handle, font_size_t font_size, uint8_t chr, uint16_t color, uint16_t bg_color);
+
+/*
+ * @brief   Write string with opaque background.
+ *
+ * @param   handle Handle structure.
+ * @param   font_size Font size.
+ * @param   str Pointer references to the data.
+ * @param 	color Color.
+ * @param 	bg_color Background color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_write_string_bg(st7735_handle_t handle, font_size_t font_size, uint8_t *str, uint16_t color, uint16_t bg_color);
+
 /*
  * @brief   Draw pixel.
  *
@@ -206,6 +380,243 @@ err_code_t st7735_draw_circle(st7735_handle_t handle, uint8_t x_origin, uint8_t
  */
 err_code_t st7735_draw_image(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src);
 
+/*
+ * @brief   Draw image from any supported pixel format.
+ *
+ * @note    Source pixels are converted in chunks into the transmit buffer
+ *          according to the current color mode.
+ *
+ * @param   handle Handle structure.
+ * @param 	x_origin x origin position.
+ * @param 	y_origin y origin position.
+ * @param 	width Image width in pixel.
+ * @param 	height Image height in pixel.
+ * @param 	image_src Image source.
+ * @param 	format Source pixel format.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_draw_image_format(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, const void *image_src, st7735_pixel_format_t format);
+
+/*
+ * @brief   Open an address window and keep the bus for streamed pixels.
+ *
+ * @note    Pixels written with st7735_stream_write fill the window row by
+ *          row. The bus stays locked and CS asserted until
+ *          st7735_stream_end. Not available while a render queue is
+ *          attached. The whole window is always written, pixels outside
+ *          the clip rectangle are dropped. On failure the bus is already
+ *          released and st7735_stream_end must not be called.
+ *
+ * @param   handle Handle structure.
+ * @param 	x_origin x origin position.
+ * @param 	y_origin y origin position.
+ * @param 	width Window width.
+ * @param 	height Window height.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_stream_begin(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height);
+
+/*
+ * @brief   Write pixels into the window opened by st7735_stream_begin.
+ *
+ * @param   handle Handle structure.
+ * @param 	src Pixel source.
+ * @param 	format Source pixel format.
+ * @param 	num_pixel Number of pixels.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_stream_write(st7735_handle_t handle, const void *src, st7735_pixel_format_t format, uint32_t num_pixel);
+
+/*
+ * @brief   Close the window opened by st7735_stream_begin and release the bus.
+ *
+ * @param   handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_stream_end(st7735_handle_t handle);
+
+/*
+ * @brief   Present a full frame, sending only the tiles that changed.
+ *
+ * @note    The frame covers the whole screen in the same format as
+ *          st7735_draw_image and ignores clip rectangle and viewport. It
+ *          is split into 16x16 tiles whose hashes are compared with the
+ *          previously presented frame. Changed tiles are merged into
+ *          rectangles, runs on a row and identical runs on following
+ *          rows, and each rectangle is sent in one window. Not available
+ *          while a render queue is attached.
+ *
+ * @param   handle Handle structure.
+ * @param 	frame Frame buffer, width x height pixels.
+ * @param 	num_rect Number of rectangles sent. Can be NULL.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, screen larger than the 132x162 GRAM or
+ *                          transfer failed. A failed transfer invalidates
+ *                          the previous frame.
+ */
+err_code_t st7735_present_frame(st7735_handle_t handle, const uint8_t *frame, uint16_t *num_rect);
+
+/*
+ * @brief   Forget the previously presented frame.
+ *
+ * @note    Call after drawing with other functions, the next
+ *          st7735_present_frame then sends the whole frame.
+ *
+ * @param   handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_invalidate_frame(st7735_handle_t handle);
+
+/*
+ * @brief   Set interface color mode.
+ *
+ * @note    Can be called before st7735_config, the mode is applied after
+ *          the init sequence. Colors passed to the API stay RGB565.
+ *
+ * @param   handle Handle structure.
+ * @param 	color_mode Color mode.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_set_color_mode(st7735_handle_t handle, st7735_color_mode_t color_mode);
+
+/*
+ * @brief   Get interface color mode.
+ *
+ * @note    In queue mode a queued mode change is reported once processed.
+ *
+ * @param   handle Handle structure.
+ * @param 	color_mode Color mode.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_get_color_mode(st7735_handle_t handle, st7735_color_mode_t *color_mode);
+
+/*
+ * @brief   Get bitmap glyph with the advance used by the text functions.
+ *
+ * @param 	font_size Font size.
+ * @param 	chr Character.
+ * @param 	glyph Glyph.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_get_glyph(font_size_t font_size, uint8_t chr, st7735_glyph_t *glyph);
+
+/*
+ * @brief   Blend two RGB565 colors.
+ *
+ * @param 	fg Foreground color.
+ * @param 	bg Background color.
+ * @param 	alpha Foreground weight, 0 to max_alpha.
+ * @param 	max_alpha Weight of a fully opaque foreground.
+ *
+ * @return  Blended color.
+ */
+uint16_t st7735_blend_color(uint16_t fg, uint16_t bg, uint8_t alpha, uint8_t max_alpha);
+
+/*
+ * @brief   Draw image with color-key transparency.
+ *
+ * @note    Pixels equal to key_color are skipped. Opaque runs of each row
+ *          are sent as one burst, transparent runs only move the address
+ *          window. Image format is the same as st7735_draw_image.
+ *
+ * @param   handle Handle structure.
+ * @param 	x_origin x origin position.
+ * @param 	y_origin y origin position.
+ * @param 	width Image width in pixel.
+ * @param 	height Image height in pixel.
+ * @param 	image_src Image source.
+ * @param 	key_color Transparent color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_draw_image_transparent(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src, uint16_t key_color);
+
+/*
+ * @brief   Draw image through an alpha mask.
+ *
+ * @note    With ST7735_MASK_1BPP a set bit marks an opaque pixel. With
+ *          ST7735_MASK_4BPP alpha 0 is transparent and 15 is opaque. Partial
+ *          alpha is blended against GRAM read back from the panel if a
+ *          receive function is configured, otherwise alpha >= 8 is drawn
+ *          opaque.
+ *
+ * @param   handle Handle structure.
+ * @param 	x_origin x origin position.
+ * @param 	y_origin y origin position.
+ * @param 	width Image width in pixel.
+ * @param 	height Image height in pixel.
+ * @param 	image_src Image source.
+ * @param 	mask Alpha mask.
+ * @param 	mask_bpp Alpha mask format.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_draw_image_masked(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src, uint8_t *mask, st7735_mask_bpp_t mask_bpp);
+
+/*
+ * @brief   Read rectangle of GRAM.
+ *
+ * @note    Requires a receive function in the configuration. Not available
+ *          while a render queue is attached.
+ *
+ * @param   handle Handle structure.
+ * @param 	x_origin x origin position.
+ * @param 	y_origin y origin position.
+ * @param 	width Width.
+ * @param 	height Height.
+ * @param 	buf Output buffer of width * height native RGB565 pixels.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_read_image(st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint16_t *buf);
+
+/*
+ * @brief   Read panel ID registers RDID1, RDID2 and RDID3.
+ *
+ * @note    Requires a receive function in the configuration. Not available
+ *          while a render queue is attached.
+ *
+ * @param   handle Handle structure.
+ * @param 	id Output buffer of 3 bytes: manufacturer, version, module ID.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_read_id(st7735_handle_t handle, uint8_t *id);
+
 /*
  * @brief   Set position.
  *
@@ -219,9 +630,122 @@ err_code_t st7735_draw_image(st7735_handle_t handle, uint8_t x_origin, uint8_t y
  */
 err_code_t st7735_set_position(st7735_handle_t handle, uint8_t x, uint8_t y);
 
+/*
+ * @brief   Push clip rectangle.
+ *
+ * @note    The rectangle is given in current local coordinates and is
+ *          intersected with the current clip rectangle. Every drawing
+ *          call, text and streamed window is clipped to it, and work that
+ *          falls entirely outside is dropped before it reaches the bus.
+ *
+ * @param   handle Handle structure.
+ * @param 	rect Clip rectangle.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, stack is full.
+ */
+err_code_t st7735_push_clip(st7735_handle_t handle, st7735_rect_t rect);
+
+/*
+ * @brief   Push viewport.
+ *
+ * @note    Same as st7735_push_clip, and the top-left corner of the
+ *          rectangle becomes the local origin. Coordinates passed to
+ *          drawing calls and st7735_set_position are relative to it until
+ *          the matching st7735_pop_clip.
+ *
+ * @param   handle Handle structure.
+ * @param 	rect Viewport rectangle.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, stack is full.
+ */
+err_code_t st7735_push_viewport(st7735_handle_t handle, st7735_rect_t rect);
+
+/*
+ * @brief   Restore the clip rectangle and origin saved by the last push.
+ *
+ * @param   handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, stack is empty.
+ */
+err_code_t st7735_pop_clip(st7735_handle_t handle);
+
+/*
+ * @brief   Attach render queue.
+ *
+ * @note    While a queue is attached, draw calls, st7735_set_position and
+ *          st7735_set_color_mode only enqueue a command and never touch the
+ *          bus. Images are referenced and must stay valid until processed.
+ *          Text position is worker state: producers that interleave
+ *          st7735_set_position and text see them applied in queue order,
+ *          st7735_get_position, the read functions and the stream API
+ *          fail. Pass NULL to return to direct mode.
+ *
+ * @param   handle Handle structure.
+ * @param 	queue Queue handle structure or NULL.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_set_queue(st7735_handle_t handle, st7735_queue_handle_t queue);
+
+/*
+ * @brief   Drain render queue.
+ *
+ * @note    Call from the single render worker, a pthread on host or a task
+ *          on target. Commands are popped in batches, overdrawn commands
+ *          before a full screen fill are dropped, adjacent pixels and
+ *          rectangles of one color are merged into spans, and each batch is
+ *          sent under one CS assertion.
+ *
+ * @param   handle Handle structure.
+ * @param 	num_cmd Number of commands processed. Can be NULL.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_process_queue(st7735_handle_t handle, uint16_t *num_cmd);
+
+/*
+ * @brief   Get attached render queue.
+ *
+ * @param   handle Handle structure.
+ * @param 	queue Queue handle structure, NULL in direct mode.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_get_queue(st7735_handle_t handle, st7735_queue_handle_t *queue);
+
+/*
+ * @brief   Attach bus tracer.
+ *
+ * @note    Every CS edge, command and data transfer of this panel is
+ *          recorded with its timestamp. Pass NULL to stop tracing.
+ *
+ * @param   handle Handle structure.
+ * @param 	trace Tracer handle structure or NULL.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_set_trace(st7735_handle_t handle, st7735_trace_handle_t trace);
+
 /*
  * @brief   Get position.
  *
+ * @note    Not available while a render queue is attached, the position
+ *          is only updated when the worker processes queued commands.
+ *
  * @param   handle Handle structure.
  * @param 	x Pointer to column index.
  * @param 	y Pointer to row index.
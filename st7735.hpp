@@ -0,0 +1,473 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_HPP__
+#define __ST7735_HPP__
+
+#include "st7735.h"
+#include "st7735_regs.h"
+
+namespace st7735cpp {
+
+/**
+ * @brief   Compile-time panel geometry.
+ */
+template <uint16_t Width, uint16_t Height, uint8_t XStart = ST7735_XSTART, uint8_t YStart = ST7735_YSTART>
+struct Geometry {
+	static constexpr uint16_t width = Width;		/*!< Screen width */
+	static constexpr uint16_t height = Height;		/*!< Screen height */
+	static constexpr uint8_t x_start = XStart;		/*!< Column offset of the visible area */
+	static constexpr uint8_t y_start = YStart;		/*!< Row offset of the visible area */
+};
+
+typedef Geometry<128, 160> Geometry128x160;
+
+/**
+ * @brief   Transport policy built from the C callbacks of st7735_cfg_t.
+ *
+ * @note    Callbacks are template arguments, so every call is direct and can
+ *          be inlined when the definition is visible. A Transport policy can
+ *          also be written by hand with the same five static functions,
+ *          set_cs, set_dc, set_rst and send returning err_code_t.
+ */
+template <st7735_func_set_gpio SetCs, st7735_func_set_gpio SetDc, st7735_func_spi_send SpiSend,
+          st7735_func_set_gpio SetRst = nullptr, st7735_func_delay Delay = nullptr>
+struct FunctionTransport {
+	static inline err_code_t set_cs(uint8_t level)
+	{
+		if (SetCs == nullptr)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		return SetCs(level);
+	}
+
+	static inline err_code_t set_dc(uint8_t level)
+	{
+		return SetDc(level);
+	}
+
+	static inline err_code_t set_rst(uint8_t level)
+	{
+		if (SetRst == nullptr)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		return SetRst(level);
+	}
+
+	static inline err_code_t send(uint8_t *buf_send, uint16_t len)
+	{
+		return SpiSend(buf_send, len);
+	}
+
+	static inline void delay(uint32_t time_ms)
+	{
+		if (Delay != nullptr)
+		{
+			Delay(time_ms);
+		}
+	}
+};
+
+/**
+ * @brief   Compile-time specialized driver.
+ *
+ * @note    Header-only counterpart of the C API for hot paths. Geometry and
+ *          transport are resolved at compile time, the transmit buffer has a
+ *          constant length, and rectangles given as template arguments are
+ *          checked by static_assert instead of at run time. Colors and image
+ *          data use the same format as the C API, and the panel can still be
+ *          driven through a st7735_handle_t on the same bus.
+ *
+ * @note    Pixels are always sent as 2-byte RGB565. config sets COLMOD to
+ *          ST7735_COLOR_MODE_16BIT, and a st7735_handle_t sharing the panel
+ *          must not switch it to ST7735_COLOR_MODE_18BIT.
+ *
+ * @note    Every method stops at the first failed transport call, releases
+ *          CS and returns ERR_CODE_FAIL.
+ *
+ * @tparam  Transport Static set_cs, set_dc, set_rst, send and delay functions.
+ * @tparam  Geo Panel geometry.
+ * @tparam  TxPixel Pixels per transmit burst.
+ */
+template <class Transport, class Geo = Geometry128x160, uint16_t TxPixel = 64>
+class Panel {
+public:
+	static constexpr uint16_t width = Geo::width;
+	static constexpr uint16_t height = Geo::height;
+
+	static_assert(width <= 256 && height <= 256, "ST7735 address range is 8-bit");
+	static_assert(TxPixel > 0, "Transmit burst must hold at least one pixel");
+
+	/*
+	 * @brief   Reset and run the init sequence of st7735_config. The panel
+	 *          is left in 16-bit color mode.
+	 */
+	static err_code_t config()
+	{
+		if (Transport::set_cs(0))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return release(init_panel());
+	}
+
+	/*
+	 * @brief   Fill screen.
+	 */
+	static err_code_t fill(uint16_t color)
+	{
+		return fill_rect<0, 0, width, height>(color);
+	}
+
+	/*
+	 * @brief   Fill rectangle known at compile time. Bounds are checked by
+	 *          the compiler, no clipping code is emitted.
+	 */
+	template <uint16_t X, uint16_t Y, uint16_t W, uint16_t H>
+	static err_code_t fill_rect(uint16_t color)
+	{
+		static_assert(W > 0 && H > 0, "Empty rectangle");
+		static_assert(X + W <= width && Y + H <= height, "Rectangle outside of the panel");
+
+		if (Transport::set_cs(0))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return release(fill_area(X, Y, W, H, color));
+	}
+
+	/*
+	 * @brief   Fill rectangle, clipped to the panel.
+	 */
+	static err_code_t fill_rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+	{
+		if (!clip(x, y, w, h))
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		if (Transport::set_cs(0))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return release(fill_area(x, y, w, h, color));
+	}
+
+	/*
+	 * @brief   Draw pixel, ignored outside of the panel.
+	 */
+	static err_code_t draw_pixel(int16_t x, int16_t y, uint16_t color)
+	{
+		if ((uint16_t)x >= width || (uint16_t)y >= height)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		uint8_t data[2] = { (uint8_t)(color >> 8), (uint8_t)(color & 0xFF) };
+
+		if (Transport::set_cs(0))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (set_addr(x, y, x, y))
+		{
+			return release(ERR_CODE_FAIL);
+		}
+
+		return release(write_data(data, 2));
+	}
+
+	/*
+	 * @brief   Draw horizontal line as one burst.
+	 */
+	static err_code_t draw_hline(int16_t x, int16_t y, int16_t len, uint16_t color)
+	{
+		return fill_rect(x, y, len, 1, color);
+	}
+
+	/*
+	 * @brief   Draw vertical line as one burst.
+	 */
+	static err_code_t draw_vline(int16_t x, int16_t y, int16_t len, uint16_t color)
+	{
+		return fill_rect(x, y, 1, len, color);
+	}
+
+	/*
+	 * @brief   Draw rectangle outline.
+	 */
+	static err_code_t draw_rectangle(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+	{
+		if (draw_hline(x, y, w + 1, color) ||
+		        draw_hline(x, y + h, w + 1, color) ||
+		        draw_vline(x, y, h + 1, color) ||
+		        draw_vline(x + w, y, h + 1, color))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	/*
+	 * @brief   Draw image in the format of st7735_draw_image, clipped to the
+	 *          panel.
+	 */
+	static err_code_t draw_image(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *image_src)
+	{
+		int16_t src_x = x, src_y = y, src_w = w;
+
+		if (!clip(x, y, w, h))
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		const uint8_t *row = image_src + ((uint32_t)(y - src_y) * src_w + (x - src_x)) * 2;
+
+		if (Transport::set_cs(0))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (set_addr(x, y, x + w - 1, y + h - 1))
+		{
+			return release(ERR_CODE_FAIL);
+		}
+
+		if (w == src_w)
+		{
+			return release(write_data(row, (uint32_t)w * h * 2));
+		}
+
+		for (int16_t row_idx = 0; row_idx < h; row_idx++)
+		{
+			if (write_data(row, (uint32_t)w * 2))
+			{
+				return release(ERR_CODE_FAIL);
+			}
+			row += (uint32_t)src_w * 2;
+		}
+
+		return release(ERR_CODE_SUCCESS);
+	}
+
+private:
+	static bool clip(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+	{
+		if (x < 0)
+		{
+			w += x;
+			x = 0;
+		}
+
+		if (y < 0)
+		{
+			h += y;
+			y = 0;
+		}
+
+		if (x + w > (int16_t)width)
+		{
+			w = width - x;
+		}
+
+		if (y + h > (int16_t)height)
+		{
+			h = height - y;
+		}
+
+		return (w > 0) && (h > 0);
+	}
+
+	/*
+	 * @brief   Release CS and pass on the first error of the transfer.
+	 */
+	static inline err_code_t release(err_code_t err)
+	{
+		if (Transport::set_cs(1) || err)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	static err_code_t init_panel()
+	{
+		if (Transport::set_rst(0))
+		{
+			return ERR_CODE_FAIL;
+		}
+		Transport::delay(5);
+		if (Transport::set_rst(1))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (write_list_cmd(init_cmds1) ||
+		        write_list_cmd(init_cmds2) ||
+		        write_list_cmd(init_cmds3))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	static inline err_code_t fill_area(uint8_t x, uint8_t y, uint16_t w, uint16_t h, uint16_t color)
+	{
+		if (set_addr(x, y, x + w - 1, y + h - 1))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return write_color_repeat(color, (uint32_t)w * h);
+	}
+
+	static inline err_code_t write_cmd(uint8_t cmd)
+	{
+		if (Transport::set_dc(0))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return Transport::send(&cmd, 1);
+	}
+
+	static inline err_code_t write_data(const uint8_t *data, uint32_t len)
+	{
+		if (Transport::set_dc(1))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		while (len)
+		{
+			uint16_t chunk = (len > 0xFFFE) ? 0xFFFE : len;
+			if (Transport::send(const_cast<uint8_t *>(data), chunk))
+			{
+				return ERR_CODE_FAIL;
+			}
+			data += chunk;
+			len -= chunk;
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	static err_code_t write_list_cmd(const uint8_t *list_cmd)
+	{
+		uint8_t num_cmd = *list_cmd++;
+
+		while (num_cmd--)
+		{
+			if (write_cmd(*list_cmd++))
+			{
+				return ERR_CODE_FAIL;
+			}
+
+			uint8_t num_arg = *list_cmd++;
+			bool has_delay = num_arg & 0x80;
+			num_arg &= ~0x80;
+			if (num_arg)
+			{
+				if (write_data(list_cmd, num_arg))
+				{
+					return ERR_CODE_FAIL;
+				}
+				list_cmd += num_arg;
+			}
+
+			if (has_delay)
+			{
+				uint16_t delay_ms = *list_cmd++;
+				Transport::delay((delay_ms == 255) ? 500 : delay_ms);
+			}
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+
+	static inline err_code_t set_addr(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+	{
+		uint8_t data[4] = { 0x00, (uint8_t)(x0 + Geo::x_start), 0x00, (uint8_t)(x1 + Geo::x_start) };
+
+		if (write_cmd(ST7735_SET_COLUMN_ADDR) || write_data(data, 4))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		data[1] = y0 + Geo::y_start;
+		data[3] = y1 + Geo::y_start;
+		if (write_cmd(ST7735_SET_ROW_ADDR) || write_data(data, 4))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		return write_cmd(ST7735_RAMWR);
+	}
+
+	static err_code_t write_color_repeat(uint16_t color, uint32_t num_pixel)
+	{
+		uint8_t buf[TxPixel * 2];
+		uint32_t fill_pixel = (num_pixel < TxPixel) ? num_pixel : TxPixel;
+
+		for (uint32_t idx = 0; idx < fill_pixel; idx++)
+		{
+			buf[idx * 2] = color >> 8;
+			buf[idx * 2 + 1] = color & 0xFF;
+		}
+
+		if (Transport::set_dc(1))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		while (num_pixel >= TxPixel)
+		{
+			if (Transport::send(buf, TxPixel * 2))
+			{
+				return ERR_CODE_FAIL;
+			}
+			num_pixel -= TxPixel;
+		}
+
+		if (num_pixel)
+		{
+			return Transport::send(buf, num_pixel * 2);
+		}
+
+		return ERR_CODE_SUCCESS;
+	}
+};
+
+} /* namespace st7735cpp */
+
+#endif /* __ST7735_HPP__ */
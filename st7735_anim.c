@@ -0,0 +1,362 @@
+#include <string.h>
+
+#include "st7735_anim.h"
+
+typedef struct st7735_anim {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	uint8_t 				x;				/*!< Left edge on screen */
+	uint8_t 				y;				/*!< Top edge on screen */
+	uint8_t 				fps;			/*!< Configured frame rate, 0 uses the stream rate */
+	bool 					loop;			/*!< Restart after the last frame */
+	st7735_anim_func_get_time get_time;		/*!< Function get time in millisecond */
+	st7735_func_delay 		delay;			/*!< Function delay */
+	const uint8_t 			*data;			/*!< Stream */
+	uint32_t 				len;			/*!< Stream length */
+	uint16_t 				width;			/*!< Animation width */
+	uint16_t 				height;			/*!< Animation height */
+	uint16_t 				num_frame;		/*!< Frames in the stream */
+	uint8_t 				stream_fps;		/*!< Frame rate stored in the stream */
+	uint16_t 				frame_idx;		/*!< Next frame to send */
+	uint32_t 				pos;			/*!< Offset of the next frame */
+	uint32_t 				num_played;		/*!< Frames sent since the first one, across loops */
+	uint32_t 				start_time;		/*!< Time the first frame was sent */
+	uint16_t 				repeat_color;	/*!< Color held in the repeat buffer */
+	uint16_t 				repeat_len;		/*!< Pixels of repeat_color in the repeat buffer */
+	uint8_t 				repeat[ST7735_ANIM_REPEAT_PIXEL * 2];	/*!< Expanded repeat packet, wire byte order */
+} st7735_anim_t;
+
+static uint16_t read_u16(const uint8_t *data)
+{
+	return data[0] | (data[1] << 8);
+}
+
+static uint32_t read_u32(const uint8_t *data)
+{
+	return data[0] | (data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static err_code_t send_repeat(st7735_anim_t *anim, uint16_t color, uint16_t num_pixel)
+{
+	/* Buffer keeps its content, long runs of one color are expanded once */
+	if ((anim->repeat_color != color) || (anim->repeat_len == 0))
+	{
+		anim->repeat_color = color;
+		anim->repeat_len = 0;
+	}
+
+	while (num_pixel)
+	{
+		uint16_t chunk = (num_pixel > ST7735_ANIM_REPEAT_PIXEL) ? ST7735_ANIM_REPEAT_PIXEL : num_pixel;
+
+		for (; anim->repeat_len < chunk; anim->repeat_len++)
+		{
+			anim->repeat[anim->repeat_len * 2] = color >> 8;
+			anim->repeat[anim->repeat_len * 2 + 1] = color & 0xFF;
+		}
+
+		if (st7735_stream_write(anim->handle, anim->repeat, ST7735_PIXEL_FORMAT_RGB565_BE, chunk))
+		{
+			return ERR_CODE_FAIL;
+		}
+		num_pixel -= chunk;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t decode_rect(st7735_anim_t *anim, const uint8_t **data, const uint8_t *end, uint32_t num_pixel)
+{
+	const uint8_t *src = *data;
+
+	while (num_pixel)
+	{
+		if (src >= end)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		uint8_t packet = *src++;
+		uint16_t count = (packet & 0x7F) + 1;
+
+		if (count > num_pixel)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (packet & 0x80)
+		{
+			if (end - src < 2)
+			{
+				return ERR_CODE_FAIL;
+			}
+
+			if (send_repeat(anim, (src[0] << 8) | src[1], count))
+			{
+				return ERR_CODE_FAIL;
+			}
+			src += 2;
+		}
+		else
+		{
+			if (end - src < count * 2)
+			{
+				return ERR_CODE_FAIL;
+			}
+
+			/* Literal pixels are already in wire format, sent from the stream */
+			if (st7735_stream_write(anim->handle, src, ST7735_PIXEL_FORMAT_RGB565_BE, count))
+			{
+				return ERR_CODE_FAIL;
+			}
+			src += count * 2;
+		}
+
+		num_pixel -= count;
+	}
+
+	*data = src;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t send_frame(st7735_anim_t *anim)
+{
+	const uint8_t *frame = &anim->data[anim->pos];
+	const uint8_t *end = frame + 4 + read_u32(frame);
+	const uint8_t *src = frame + ST7735_ANIM_FRAME_HEADER_LEN;
+	uint16_t num_rect = read_u16(&frame[4]);
+
+	for (uint16_t idx = 0; idx < num_rect; idx++)
+	{
+		if (end - src < 4)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		uint8_t x = src[0], y = src[1], width = src[2], height = src[3];
+		src += 4;
+
+		if ((width == 0) || (height == 0) || (x + width > anim->width) || (y + height > anim->height))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (st7735_stream_begin(anim->handle, anim->x + x, anim->y + y, width, height))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		err_code_t err = decode_rect(anim, &src, end, (uint32_t)width * height);
+		st7735_stream_end(anim->handle);
+
+		if (err)
+		{
+			return ERR_CODE_FAIL;
+		}
+	}
+
+	anim->pos = end - anim->data;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static uint32_t get_due_time(st7735_anim_t *anim)
+{
+	uint8_t fps = anim->fps ? anim->fps : anim->stream_fps;
+
+	if (fps == 0)
+	{
+		return anim->start_time;
+	}
+
+	return anim->start_time + (uint32_t)((uint64_t)anim->num_played * 1000 / fps);
+}
+
+#ifndef ST7735_STATIC_ONLY
+st7735_anim_handle_t st7735_anim_init(void)
+{
+	st7735_anim_handle_t anim = calloc(1, sizeof(st7735_anim_t));
+	if (anim == NULL)
+	{
+		return NULL;
+	}
+
+	return anim;
+}
+#endif
+
+size_t st7735_anim_get_static_size(void)
+{
+	return ST7735_ARENA_ROUND(sizeof(st7735_anim_t));
+}
+
+st7735_anim_handle_t st7735_anim_init_static(st7735_arena_t *arena)
+{
+	return st7735_arena_alloc(arena, sizeof(st7735_anim_t));
+}
+
+err_code_t st7735_anim_set_config(st7735_anim_handle_t anim, st7735_anim_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if ((anim == NULL) || (config.handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* An opened stream must still fit the 8-bit address range at the new position */
+	if ((anim->data != NULL) && ((config.x + anim->width > 0xFF) || (config.y + anim->height > 0xFF)))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	anim->handle = config.handle;
+	anim->x = config.x;
+	anim->y = config.y;
+	anim->fps = config.fps;
+	anim->loop = config.loop;
+	anim->get_time = config.get_time;
+	anim->delay = config.delay;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_anim_open(st7735_anim_handle_t anim, const uint8_t *data, uint32_t len)
+{
+	/* Check if handle structure is NULL */
+	if ((anim == NULL) || (data == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((len < ST7735_ANIM_HEADER_LEN) || memcmp(data, "S7AN", 4) || (data[4] != ST7735_ANIM_VERSION))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint16_t width = read_u16(&data[6]);
+	uint16_t height = read_u16(&data[8]);
+	uint16_t num_frame = read_u16(&data[10]);
+	uint32_t pos = ST7735_ANIM_HEADER_LEN;
+
+	if ((anim->x + width > 0xFF) || (anim->y + height > 0xFF))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* Walk the frame chain once so playback never reads past the stream */
+	for (uint16_t idx = 0; idx < num_frame; idx++)
+	{
+		if ((len - pos < ST7735_ANIM_FRAME_HEADER_LEN) || (read_u32(&data[pos]) > len - pos - 4) ||
+		        (read_u32(&data[pos]) < ST7735_ANIM_FRAME_HEADER_LEN - 4))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if ((idx == 0) && !(data[pos + 6] & ST7735_ANIM_FLAG_KEYFRAME))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		pos += 4 + read_u32(&data[pos]);
+	}
+
+	anim->data = data;
+	anim->len = len;
+	anim->width = width;
+	anim->height = height;
+	anim->num_frame = num_frame;
+	anim->stream_fps = data[12];
+	anim->frame_idx = 0;
+	anim->pos = ST7735_ANIM_HEADER_LEN;
+	anim->num_played = 0;
+	anim->repeat_len = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_anim_update(st7735_anim_handle_t anim, bool *finished)
+{
+	/* Check if handle structure is NULL */
+	if ((anim == NULL) || (anim->handle == NULL) || (anim->data == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (finished != NULL)
+	{
+		*finished = false;
+	}
+
+	if (anim->frame_idx >= anim->num_frame)
+	{
+		if (!anim->loop || (anim->num_frame == 0))
+		{
+			if (finished != NULL)
+			{
+				*finished = true;
+			}
+			return ERR_CODE_SUCCESS;
+		}
+
+		/* First frame is a keyframe, restarting needs no clear */
+		anim->frame_idx = 0;
+		anim->pos = ST7735_ANIM_HEADER_LEN;
+	}
+
+	if (anim->get_time != NULL)
+	{
+		uint32_t now = anim->get_time();
+
+		if (anim->num_played == 0)
+		{
+			anim->start_time = now;
+		}
+		else if ((int32_t)(now - get_due_time(anim)) < 0)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+	}
+
+	if (send_frame(anim))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	anim->frame_idx++;
+	anim->num_played++;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_anim_play(st7735_anim_handle_t anim)
+{
+	/* Check if handle structure is NULL */
+	if ((anim == NULL) || (anim->handle == NULL) || (anim->data == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	bool finished = false;
+
+	while (true)
+	{
+		if ((anim->get_time != NULL) && (anim->delay != NULL) && (anim->num_played > 0))
+		{
+			int32_t wait = (int32_t)(get_due_time(anim) - anim->get_time());
+			if (wait > 0)
+			{
+				anim->delay(wait);
+			}
+		}
+
+		if (st7735_anim_update(anim, &finished))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (finished)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+	}
+}
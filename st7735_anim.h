@@ -0,0 +1,181 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_ANIM_H__
+#define __ST7735_ANIM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "st7735.h"
+
+/*
+ * Delta-frame stream, produced by tools/st7735_animc.py. Multi-byte fields
+ * are little endian, pixels are RGB565 big endian as in st7735_draw_image.
+ *
+ *   Header, 16 bytes:
+ *     "S7AN", version (1), flags (0), width (u16), height (u16),
+ *     number of frames (u16), frames per second (u8), 3 reserved bytes.
+ *
+ *   Each frame:
+ *     body size in bytes after this field (u32), number of rectangles (u16),
+ *     flags (u8, bit 0 set on keyframes), reserved (u8), then for each
+ *     rectangle x, y, width, height (u8 each) followed by width x height
+ *     pixels in packets:
+ *       0x00-0x7F: n + 1 literal pixels follow.
+ *       0x80-0xFF: one pixel follows, repeated (n & 0x7F) + 1 times.
+ *     Packets continue across rows of the rectangle.
+ *
+ * The first frame is a keyframe covering the whole animation.
+ */
+
+#define ST7735_ANIM_VERSION 			1		/*!< Stream format version */
+#define ST7735_ANIM_HEADER_LEN 			16		/*!< Stream header length */
+#define ST7735_ANIM_FRAME_HEADER_LEN 	8		/*!< Frame header length including the size field */
+#define ST7735_ANIM_FLAG_KEYFRAME 		0x01	/*!< Frame redraws the whole animation */
+#define ST7735_ANIM_REPEAT_PIXEL 		64		/*!< Pixels expanded at once from a repeat packet */
+
+typedef uint32_t (*st7735_anim_func_get_time)(void);
+
+/**
+ * @brief   Animation player handle structure.
+ */
+typedef struct st7735_anim *st7735_anim_handle_t;
+
+/**
+ * @brief   Animation player configuration structure.
+ */
+typedef struct {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	uint8_t 				x;				/*!< Left edge of the animation on screen */
+	uint8_t 				y;				/*!< Top edge of the animation on screen */
+	uint8_t 				fps;			/*!< Frame rate, 0 uses the rate stored in the stream */
+	bool 					loop;			/*!< Restart from the first frame after the last one */
+	st7735_anim_func_get_time get_time;		/*!< Function get time in millisecond */
+	st7735_func_delay 		delay;			/*!< Function delay, used by st7735_anim_play */
+} st7735_anim_cfg_t;
+
+/*
+ * @brief   Initialize animation player.
+ *
+ * @note    Frames are decoded directly from the stream, which may sit in
+ *          memory-mapped flash. Literal pixels are sent from the stream
+ *          without copying, repeated pixels are expanded into a small
+ *          buffer, so no frame buffer is needed.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+#ifndef ST7735_STATIC_ONLY
+st7735_anim_handle_t st7735_anim_init(void);
+#endif
+
+/*
+ * @brief   Get arena space needed by st7735_anim_init_static.
+ *
+ * @param   None.
+ *
+ * @return  Size in bytes, rounded to ST7735_ARENA_ALIGN.
+ */
+size_t st7735_anim_get_static_size(void);
+
+/*
+ * @brief   Initialize animation player with storage carved from a work arena.
+ *
+ * @param   arena Work arena.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail, arena exhausted.
+ */
+st7735_anim_handle_t st7735_anim_init_static(st7735_arena_t *arena);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @note    With a stream open, x + width and y + height of the animation
+ *          must not exceed 255.
+ *
+ * @param   anim Animation player handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_anim_set_config(st7735_anim_handle_t anim, st7735_anim_cfg_t config);
+
+/*
+ * @brief   Open stream and rewind to the first frame.
+ *
+ * @note    x + width and y + height of the animation at the configured
+ *          position must not exceed 255.
+ *
+ * @param   anim Animation player handle structure.
+ * @param   data Stream, must stay valid while playing.
+ * @param   len Stream length.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, stream is malformed or does not fit.
+ */
+err_code_t st7735_anim_open(st7735_anim_handle_t anim, const uint8_t *data, uint32_t len);
+
+/*
+ * @brief   Send the next frame if it is due.
+ *
+ * @note    Frames are scheduled from the time the first frame was sent, so
+ *          late frames do not accumulate drift. Delta frames cannot be
+ *          skipped, a late frame is sent as soon as possible.
+ *
+ * @param   anim Animation player handle structure.
+ * @param   finished Set to true after the last frame when not looping. Can be NULL.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_anim_update(st7735_anim_handle_t anim, bool *finished);
+
+/*
+ * @brief   Play the animation to its end, waiting between frames.
+ *
+ * @note    Returns after the last frame. With loop enabled it never returns
+ *          unless a frame fails.
+ *
+ * @param   anim Animation player handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_anim_play(st7735_anim_handle_t anim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_ANIM_H__ */
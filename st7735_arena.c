@@ -0,0 +1,53 @@
+#include <string.h>
+
+#include "st7735_arena.h"
+
+err_code_t st7735_arena_init(st7735_arena_t *arena, void *buf, size_t size)
+{
+	/* Check if handle structure is NULL */
+	if ((arena == NULL) || (buf == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((uintptr_t)buf % ST7735_ARENA_ALIGN)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	arena->buf = buf;
+	arena->size = size;
+	arena->used = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+void *st7735_arena_alloc(st7735_arena_t *arena, size_t size)
+{
+	if ((arena == NULL) || (arena->buf == NULL))
+	{
+		return NULL;
+	}
+
+	size = ST7735_ARENA_ROUND(size);
+	if (size > arena->size - arena->used)
+	{
+		return NULL;
+	}
+
+	void *block = &arena->buf[arena->used];
+	arena->used += size;
+	memset(block, 0, size);
+
+	return block;
+}
+
+size_t st7735_arena_get_free(const st7735_arena_t *arena)
+{
+	if (arena == NULL)
+	{
+		return 0;
+	}
+
+	return arena->size - arena->used;
+}
@@ -0,0 +1,95 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_ARENA_H__
+#define __ST7735_ARENA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "err_code.h"
+
+/*
+ * Define ST7735_STATIC_ONLY to compile out every init function that
+ * allocates from the heap. Only the *_init_static variants remain.
+ */
+
+#define ST7735_ARENA_ALIGN 				8		/*!< Alignment of arena buffer and every block carved from it */
+#define ST7735_ARENA_ROUND(size) 		(((size) + ST7735_ARENA_ALIGN - 1) & ~((size_t)ST7735_ARENA_ALIGN - 1))
+
+/**
+ * @brief   Work arena structure. Owned by the caller, blocks are carved
+ *          from the front and never released.
+ */
+typedef struct {
+	uint8_t 				*buf;			/*!< Arena buffer */
+	size_t 					size;			/*!< Buffer size */
+	size_t 					used;			/*!< Bytes already carved */
+} st7735_arena_t;
+
+/*
+ * @brief   Initialize arena over a caller-provided buffer.
+ *
+ * @note    The buffer must be aligned to ST7735_ARENA_ALIGN. Size it with
+ *          the sum of the *_get_static_size queries of everything that
+ *          will be created from it.
+ *
+ * @param   arena Arena structure.
+ * @param   buf Buffer.
+ * @param   size Buffer size.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_arena_init(st7735_arena_t *arena, void *buf, size_t size);
+
+/*
+ * @brief   Carve a zeroed block from the arena.
+ *
+ * @param   arena Arena structure.
+ * @param   size Block size, rounded up to ST7735_ARENA_ALIGN.
+ *
+ * @return
+ *      - Block: Success.
+ *      - NULL:  Fail, arena exhausted.
+ */
+void *st7735_arena_alloc(st7735_arena_t *arena, size_t size);
+
+/*
+ * @brief   Get number of bytes still available in the arena.
+ *
+ * @param   arena Arena structure.
+ *
+ * @return  Free bytes.
+ */
+size_t st7735_arena_get_free(const st7735_arena_t *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_ARENA_H__ */
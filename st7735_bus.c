@@ -0,0 +1,254 @@
+#include "st7735_bus.h"
+
+typedef enum {
+	ST7735_BUS_JOB_NONE = 0,
+	ST7735_BUS_JOB_FILL,
+	ST7735_BUS_JOB_IMAGE,
+} st7735_bus_job_type_t;
+
+typedef struct {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	st7735_bus_job_type_t 	type;			/*!< Pending transfer type */
+	uint8_t 				x_origin;		/*!< Transfer x origin */
+	uint8_t 				y_origin;		/*!< Next row to send */
+	uint8_t 				width;			/*!< Transfer width */
+	uint8_t 				height;			/*!< Rows left to send */
+	uint16_t 				color;			/*!< Fill color */
+	uint8_t 				*image_src;		/*!< Next image row to send */
+} st7735_bus_panel_t;
+
+typedef struct st7735_bus {
+	uint32_t 				quantum;		/*!< Bytes per panel per round */
+	uint8_t 				num_panel;		/*!< Number of attached panels */
+	uint8_t 				next_panel;		/*!< Panel served first in the next round */
+	st7735_bus_panel_t 		panel[ST7735_BUS_MAX_PANEL];	/*!< Attached panels */
+} st7735_bus_t;
+
+static st7735_bus_panel_t *find_panel(st7735_bus_handle_t bus, st7735_handle_t handle)
+{
+	for (uint8_t idx = 0; idx < bus->num_panel; idx++)
+	{
+		if (bus->panel[idx].handle == handle)
+		{
+			return &bus->panel[idx];
+		}
+	}
+
+	return NULL;
+}
+
+static err_code_t send_slice(st7735_bus_t *bus, st7735_bus_panel_t *panel)
+{
+	st7735_color_mode_t color_mode = ST7735_COLOR_MODE_16BIT;
+	st7735_get_color_mode(panel->handle, &color_mode);
+
+	/* Quantum counts bytes on the wire, image rows stay RGB565 in memory */
+	uint32_t row_size = (uint32_t)panel->width * 2;
+	uint32_t wire_row_size = (uint32_t)panel->width * ((color_mode == ST7735_COLOR_MODE_18BIT) ? 3 : 2);
+	uint32_t num_row = bus->quantum / wire_row_size;
+	err_code_t err;
+
+	if (num_row == 0)
+	{
+		num_row = 1;
+	}
+
+	if (num_row > panel->height)
+	{
+		num_row = panel->height;
+	}
+
+	if (panel->type == ST7735_BUS_JOB_FILL)
+	{
+		err = st7735_fill_rect(panel->handle, panel->x_origin, panel->y_origin, panel->width, num_row, panel->color);
+	}
+	else
+	{
+		err = st7735_draw_image(panel->handle, panel->x_origin, panel->y_origin, panel->width, num_row, panel->image_src);
+		panel->image_src += num_row * row_size;
+	}
+
+	panel->y_origin += num_row;
+	panel->height -= num_row;
+	if ((panel->height == 0) || err)
+	{
+		panel->type = ST7735_BUS_JOB_NONE;
+	}
+
+	return err;
+}
+
+static err_code_t submit(st7735_bus_handle_t bus, st7735_handle_t handle, st7735_bus_job_type_t type, uint8_t x_origin, uint8_t y_origin,
+                         uint8_t width, uint8_t height, uint16_t color, uint8_t *image_src)
+{
+	/* Check if handle structure is NULL */
+	if ((bus == NULL) || (handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	st7735_bus_panel_t *panel = find_panel(bus, handle);
+	if ((panel == NULL) || (panel->type != ST7735_BUS_JOB_NONE))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	if ((width == 0) || (height == 0))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	panel->x_origin = x_origin;
+	panel->y_origin = y_origin;
+	panel->width = width;
+	panel->height = height;
+	panel->color = color;
+	panel->image_src = image_src;
+	panel->type = type;
+
+	return ERR_CODE_SUCCESS;
+}
+
+#ifndef ST7735_STATIC_ONLY
+st7735_bus_handle_t st7735_bus_init(void)
+{
+	st7735_bus_handle_t bus = calloc(1, sizeof(st7735_bus_t));
+	if (bus == NULL)
+	{
+		return NULL;
+	}
+
+	bus->quantum = ST7735_BUS_DEFAULT_QUANTUM;
+
+	return bus;
+}
+#endif
+
+size_t st7735_bus_get_static_size(void)
+{
+	return ST7735_ARENA_ROUND(sizeof(st7735_bus_t));
+}
+
+st7735_bus_handle_t st7735_bus_init_static(st7735_arena_t *arena)
+{
+	st7735_bus_handle_t bus = st7735_arena_alloc(arena, sizeof(st7735_bus_t));
+	if (bus == NULL)
+	{
+		return NULL;
+	}
+
+	bus->quantum = ST7735_BUS_DEFAULT_QUANTUM;
+
+	return bus;
+}
+
+err_code_t st7735_bus_set_config(st7735_bus_handle_t bus, st7735_bus_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (bus == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	bus->quantum = (config.quantum != 0) ? config.quantum : ST7735_BUS_DEFAULT_QUANTUM;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_bus_add_panel(st7735_bus_handle_t bus, st7735_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((bus == NULL) || (handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((bus->num_panel >= ST7735_BUS_MAX_PANEL) || (find_panel(bus, handle) != NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	bus->panel[bus->num_panel].handle = handle;
+	bus->panel[bus->num_panel].type = ST7735_BUS_JOB_NONE;
+	bus->num_panel++;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_bus_submit_fill(st7735_bus_handle_t bus, st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint16_t color)
+{
+	return submit(bus, handle, ST7735_BUS_JOB_FILL, x_origin, y_origin, width, height, color, NULL);
+}
+
+err_code_t st7735_bus_submit_image(st7735_bus_handle_t bus, st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src)
+{
+	if (image_src == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	return submit(bus, handle, ST7735_BUS_JOB_IMAGE, x_origin, y_origin, width, height, 0, image_src);
+}
+
+err_code_t st7735_bus_process(st7735_bus_handle_t bus, bool *busy)
+{
+	/* Check if handle structure is NULL */
+	if (bus == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	err_code_t err = ERR_CODE_SUCCESS;
+	bool pending = false;
+
+	/* Rotate the starting panel so no panel always goes first */
+	for (uint8_t count = 0; count < bus->num_panel; count++)
+	{
+		st7735_bus_panel_t *panel = &bus->panel[(bus->next_panel + count) % bus->num_panel];
+		if (panel->type == ST7735_BUS_JOB_NONE)
+		{
+			continue;
+		}
+
+		if (send_slice(bus, panel))
+		{
+			err = ERR_CODE_FAIL;
+		}
+
+		pending |= (panel->type != ST7735_BUS_JOB_NONE);
+	}
+
+	if (bus->num_panel)
+	{
+		bus->next_panel = (bus->next_panel + 1) % bus->num_panel;
+	}
+
+	if (busy != NULL)
+	{
+		*busy = pending;
+	}
+
+	return err;
+}
+
+err_code_t st7735_bus_flush(st7735_bus_handle_t bus)
+{
+	/* Check if handle structure is NULL */
+	if (bus == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	bool busy = true;
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	while (busy)
+	{
+		if (st7735_bus_process(bus, &busy))
+		{
+			err = ERR_CODE_FAIL;
+		}
+	}
+
+	return err;
+}
@@ -0,0 +1,175 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_BUS_H__
+#define __ST7735_BUS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "st7735.h"
+
+#define ST7735_BUS_MAX_PANEL 			4		/*!< Maximum number of panels sharing one bus */
+#define ST7735_BUS_DEFAULT_QUANTUM 		2048	/*!< Default number of bytes sent per panel per round */
+
+/**
+ * @brief   Shared bus handle structure.
+ */
+typedef struct st7735_bus *st7735_bus_handle_t;
+
+/**
+ * @brief   Shared bus configuration structure.
+ */
+typedef struct {
+	uint32_t 				quantum;		/*!< Bytes sent to one panel before the bus moves on to the next */
+} st7735_bus_cfg_t;
+
+/*
+ * @brief   Initialize shared bus scheduler.
+ *
+ * @note    Large transfers submitted to the bus are split into slices of
+ *          whole rows and sent round-robin, one slice per busy panel per
+ *          round. Each slice is a complete CS-held sequence, so panel lock
+ *          hooks are taken and released per slice.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+#ifndef ST7735_STATIC_ONLY
+st7735_bus_handle_t st7735_bus_init(void);
+#endif
+
+/*
+ * @brief   Get arena space needed by st7735_bus_init_static.
+ *
+ * @param   None.
+ *
+ * @return  Size in bytes, rounded to ST7735_ARENA_ALIGN.
+ */
+size_t st7735_bus_get_static_size(void);
+
+/*
+ * @brief   Initialize shared bus scheduler with storage carved from a work arena.
+ *
+ * @param   arena Work arena.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail, arena exhausted.
+ */
+st7735_bus_handle_t st7735_bus_init_static(st7735_arena_t *arena);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	bus Bus handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_bus_set_config(st7735_bus_handle_t bus, st7735_bus_cfg_t config);
+
+/*
+ * @brief   Attach panel to the bus.
+ *
+ * @param 	bus Bus handle structure.
+ * @param 	handle Panel handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_bus_add_panel(st7735_bus_handle_t bus, st7735_handle_t handle);
+
+/*
+ * @brief   Queue rectangle fill on a panel.
+ *
+ * @note    One transfer can be pending per panel.
+ *
+ * @param 	bus Bus handle structure.
+ * @param 	handle Panel handle structure.
+ * @param 	x_origin x origin position.
+ * @param 	y_origin y origin position.
+ * @param 	width Width.
+ * @param 	height Height.
+ * @param 	color Color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, panel unknown or busy.
+ */
+err_code_t st7735_bus_submit_fill(st7735_bus_handle_t bus, st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint16_t color);
+
+/*
+ * @brief   Queue image transfer on a panel.
+ *
+ * @note    One transfer can be pending per panel. Image must stay valid
+ *          until the transfer completes.
+ *
+ * @param 	bus Bus handle structure.
+ * @param 	handle Panel handle structure.
+ * @param 	x_origin x origin position.
+ * @param 	y_origin y origin position.
+ * @param 	width Image width in pixel.
+ * @param 	height Image height in pixel.
+ * @param 	image_src Image source, format of st7735_draw_image.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, panel unknown or busy.
+ */
+err_code_t st7735_bus_submit_image(st7735_bus_handle_t bus, st7735_handle_t handle, uint8_t x_origin, uint8_t y_origin, uint8_t width, uint8_t height, uint8_t *image_src);
+
+/*
+ * @brief   Send one slice to every panel with pending transfer.
+ *
+ * @param 	bus Bus handle structure.
+ * @param 	busy Set to true if transfers are still pending. Can be NULL.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_bus_process(st7735_bus_handle_t bus, bool *busy);
+
+/*
+ * @brief   Run the scheduler until all pending transfers complete.
+ *
+ * @param 	bus Bus handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_bus_flush(st7735_bus_handle_t bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_BUS_H__ */
@@ -0,0 +1,535 @@
+#include <string.h>
+
+#include "st7735_console.h"
+
+#define CONSOLE_COLOR_DEFAULT_FG 		16		/*!< Palette index of the configured text color */
+#define CONSOLE_COLOR_DEFAULT_BG 		17		/*!< Palette index of the configured background */
+#define CONSOLE_MAX_PARAM 				4		/*!< Escape sequence parameters kept */
+
+typedef enum {
+	CONSOLE_STATE_TEXT = 0,
+	CONSOLE_STATE_ESC,
+	CONSOLE_STATE_CSI,
+} console_state_t;
+
+typedef struct {
+	uint8_t 				chr;			/*!< Character */
+	uint8_t 				fg;				/*!< Palette index of text */
+	uint8_t 				bg;				/*!< Palette index of background */
+} console_cell_t;
+
+typedef struct st7735_console {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	uint8_t 				x;				/*!< Left edge of the grid */
+	uint8_t 				y;				/*!< Top edge of the grid */
+	uint8_t 				cols;			/*!< Number of columns */
+	uint8_t 				rows;			/*!< Number of rows */
+	font_size_t 			font_size;		/*!< Font size */
+	uint8_t 				cell_width;		/*!< Cell width in pixel */
+	uint8_t 				cell_height;	/*!< Cell height in pixel */
+	uint16_t 				palette[18];	/*!< ANSI colors followed by default fg and bg */
+	console_cell_t 			*grid;			/*!< Cells, rows stored as a ring */
+	console_cell_t 			*shadow;		/*!< Cells as last drawn, in screen order */
+	uint16_t 				num_reserved;	/*!< Cells reserved by static init, 0 if grid is on the heap */
+	uint8_t 				top;			/*!< Ring index of the first screen row */
+	uint8_t 				cur_col;		/*!< Cursor column */
+	uint8_t 				cur_row;		/*!< Cursor row */
+	uint8_t 				fg;				/*!< Current text color */
+	uint8_t 				bg;				/*!< Current background color */
+	bool 					bold;			/*!< Bright text colors */
+	bool 					full_redraw;	/*!< Panel content unknown */
+	console_state_t 		state;			/*!< Escape parser state */
+	uint8_t 				num_param;		/*!< Number of escape parameters */
+	uint16_t 				param[CONSOLE_MAX_PARAM];	/*!< Escape parameters */
+	uint16_t 				line[ST7735_CONSOLE_ROW_LEN];	/*!< Pixel row being composed */
+} st7735_console_t;
+
+/* VGA text mode colors, normal then bright */
+static const uint16_t ansi_palette[16] = {
+	0x0000, 0xA800, 0x0540, 0xAAA0, 0x0015, 0xA815, 0x0555, 0xAD55,
+	0x52AA, 0xFAAA, 0x57EA, 0xFFEA, 0x52BF, 0xFABF, 0x57FF, 0xFFFF,
+};
+
+static console_cell_t *get_row(st7735_console_t *console, uint8_t row)
+{
+	return &console->grid[((console->top + row) % console->rows) * console->cols];
+}
+
+static void clear_cells(st7735_console_t *console, console_cell_t *cell, uint8_t num)
+{
+	for (uint8_t idx = 0; idx < num; idx++)
+	{
+		cell[idx].chr = ' ';
+		cell[idx].fg = console->fg;
+		cell[idx].bg = console->bg;
+	}
+}
+
+static void clear_grid(st7735_console_t *console)
+{
+	for (uint8_t row = 0; row < console->rows; row++)
+	{
+		clear_cells(console, get_row(console, row), console->cols);
+	}
+
+	console->cur_col = 0;
+	console->cur_row = 0;
+}
+
+static void new_line(st7735_console_t *console)
+{
+	console->cur_col = 0;
+
+	if (console->cur_row + 1 < console->rows)
+	{
+		console->cur_row++;
+		return;
+	}
+
+	/* Scrolling only rotates the ring, the refresh diff finds what moved */
+	console->top = (console->top + 1) % console->rows;
+	clear_cells(console, get_row(console, console->rows - 1), console->cols);
+}
+
+static void put_char(st7735_console_t *console, uint8_t chr)
+{
+	if (console->cur_col >= console->cols)
+	{
+		new_line(console);
+	}
+
+	console_cell_t *cell = &get_row(console, console->cur_row)[console->cur_col++];
+	cell->chr = chr;
+	cell->fg = (console->bold && (console->fg < 8)) ? console->fg + 8 : console->fg;
+	cell->bg = console->bg;
+}
+
+static void apply_sgr(st7735_console_t *console)
+{
+	/* ESC[m is the same as ESC[0m */
+	if (console->num_param == 0)
+	{
+		console->param[0] = 0;
+		console->num_param = 1;
+	}
+
+	for (uint8_t idx = 0; idx < console->num_param; idx++)
+	{
+		uint16_t code = console->param[idx];
+
+		if (code == 0)
+		{
+			console->fg = CONSOLE_COLOR_DEFAULT_FG;
+			console->bg = CONSOLE_COLOR_DEFAULT_BG;
+			console->bold = false;
+		}
+		else if (code == 1)
+		{
+			console->bold = true;
+		}
+		else if (code == 22)
+		{
+			console->bold = false;
+		}
+		else if ((code >= 30) && (code <= 37))
+		{
+			console->fg = code - 30;
+		}
+		else if (code == 39)
+		{
+			console->fg = CONSOLE_COLOR_DEFAULT_FG;
+		}
+		else if ((code >= 40) && (code <= 47))
+		{
+			console->bg = code - 40;
+		}
+		else if (code == 49)
+		{
+			console->bg = CONSOLE_COLOR_DEFAULT_BG;
+		}
+		else if ((code >= 90) && (code <= 97))
+		{
+			console->fg = code - 90 + 8;
+		}
+		else if ((code >= 100) && (code <= 107))
+		{
+			console->bg = code - 100 + 8;
+		}
+	}
+}
+
+static void apply_csi(st7735_console_t *console, uint8_t final)
+{
+	uint16_t arg = (console->num_param > 0) ? console->param[0] : 0;
+
+	switch (final)
+	{
+	case 'm':
+		apply_sgr(console);
+		break;
+
+	case 'J':
+		if (arg == 2)
+		{
+			clear_grid(console);
+		}
+		break;
+
+	case 'K':
+		if (console->cur_col < console->cols)
+		{
+			console_cell_t *row = get_row(console, console->cur_row);
+			clear_cells(console, &row[console->cur_col], console->cols - console->cur_col);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void feed(st7735_console_t *console, uint8_t chr)
+{
+	switch (console->state)
+	{
+	case CONSOLE_STATE_ESC:
+		if (chr == '[')
+		{
+			console->state = CONSOLE_STATE_CSI;
+			console->num_param = 0;
+			memset(console->param, 0, sizeof(console->param));
+		}
+		else
+		{
+			console->state = CONSOLE_STATE_TEXT;
+		}
+		return;
+
+	case CONSOLE_STATE_CSI:
+		if ((chr >= '0') && (chr <= '9'))
+		{
+			if (console->num_param == 0)
+			{
+				console->num_param = 1;
+			}
+
+			if (console->num_param <= CONSOLE_MAX_PARAM)
+			{
+				console->param[console->num_param - 1] = console->param[console->num_param - 1] * 10 + (chr - '0');
+			}
+		}
+		else if (chr == ';')
+		{
+			/* An empty parameter counts as zero */
+			if (console->num_param == 0)
+			{
+				console->num_param = 1;
+			}
+			console->num_param++;
+		}
+		else if ((chr >= 0x40) && (chr <= 0x7E))
+		{
+			if (console->num_param > CONSOLE_MAX_PARAM)
+			{
+				console->num_param = CONSOLE_MAX_PARAM;
+			}
+			apply_csi(console, chr);
+			console->state = CONSOLE_STATE_TEXT;
+		}
+		return;
+
+	default:
+		break;
+	}
+
+	switch (chr)
+	{
+	case 0x1B:
+		console->state = CONSOLE_STATE_ESC;
+		break;
+
+	case '\n':
+		new_line(console);
+		break;
+
+	case '\r':
+		console->cur_col = 0;
+		break;
+
+	case '\b':
+		if (console->cur_col > 0)
+		{
+			console->cur_col--;
+		}
+		break;
+
+	case '\t':
+		do
+		{
+			put_char(console, ' ');
+		} while ((console->cur_col % ST7735_CONSOLE_TAB_WIDTH) && (console->cur_col < console->cols));
+		break;
+
+	default:
+		if (chr >= ' ')
+		{
+			put_char(console, chr);
+		}
+		break;
+	}
+}
+
+static bool cell_equal(const console_cell_t *a, const console_cell_t *b)
+{
+	return (a->chr == b->chr) && (a->fg == b->fg) && (a->bg == b->bg);
+}
+
+static err_code_t draw_cells(st7735_console_t *console, uint8_t row, uint8_t col, uint8_t num, const console_cell_t *cell)
+{
+	uint16_t *line = console->line;
+	uint16_t width = num * console->cell_width;
+
+	if (st7735_stream_begin(console->handle, console->x + col * console->cell_width,
+	                        console->y + row * console->cell_height, width, console->cell_height))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	for (uint8_t height_idx = 0; height_idx < console->cell_height; height_idx++)
+	{
+		uint16_t *pixel = line;
+
+		for (uint8_t idx = 0; idx < num; idx++)
+		{
+			st7735_glyph_t glyph;
+			st7735_get_glyph(console->font_size, cell[idx].chr, &glyph);
+
+			uint16_t fg = console->palette[cell[idx].fg];
+			uint16_t bg = console->palette[cell[idx].bg];
+
+			for (uint8_t width_idx = 0; width_idx < console->cell_width; width_idx++)
+			{
+				*pixel++ = ST7735_GLYPH_PIXEL(&glyph, height_idx, width_idx) ? fg : bg;
+			}
+		}
+
+		if (st7735_stream_write(console->handle, line, ST7735_PIXEL_FORMAT_RGB565, width))
+		{
+			st7735_stream_end(console->handle);
+			return ERR_CODE_FAIL;
+		}
+	}
+
+	return st7735_stream_end(console->handle);
+}
+
+#ifndef ST7735_STATIC_ONLY
+st7735_console_handle_t st7735_console_init(void)
+{
+	st7735_console_handle_t console = calloc(1, sizeof(st7735_console_t));
+	if (console == NULL)
+	{
+		return NULL;
+	}
+
+	return console;
+}
+#endif
+
+size_t st7735_console_get_static_size(uint8_t cols, uint8_t rows)
+{
+	return ST7735_ARENA_ROUND(sizeof(st7735_console_t)) + 2 * ST7735_ARENA_ROUND((size_t)cols * rows * sizeof(console_cell_t));
+}
+
+st7735_console_handle_t st7735_console_init_static(st7735_arena_t *arena, uint8_t cols, uint8_t rows)
+{
+	uint16_t num_cell = (uint16_t)cols * rows;
+
+	if ((num_cell == 0) || (st7735_arena_get_free(arena) < st7735_console_get_static_size(cols, rows)))
+	{
+		return NULL;
+	}
+
+	st7735_console_handle_t console = st7735_arena_alloc(arena, sizeof(st7735_console_t));
+	console->grid = st7735_arena_alloc(arena, num_cell * sizeof(console_cell_t));
+	console->shadow = st7735_arena_alloc(arena, num_cell * sizeof(console_cell_t));
+	console->num_reserved = num_cell;
+
+	return console;
+}
+
+err_code_t st7735_console_set_config(st7735_console_handle_t console, st7735_console_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if ((console == NULL) || (config.handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	st7735_glyph_t glyph;
+	st7735_get_glyph(config.font_size, ' ', &glyph);
+	uint8_t cell_width = glyph.advance;
+
+	/* Refresh windows use 8-bit panel coordinates */
+	if ((config.cols == 0) || (config.rows == 0) || ((uint16_t)config.cols * cell_width >= ST7735_CONSOLE_ROW_LEN) ||
+	        (config.x + (uint16_t)config.cols * cell_width > 0xFF) || (config.y + (uint16_t)config.rows * glyph.height > 0xFF))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* Refresh streams cell runs, which a render queue cannot carry */
+	st7735_queue_handle_t queue;
+	if (st7735_get_queue(config.handle, &queue) || (queue != NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint16_t num_cell = (uint16_t)config.cols * config.rows;
+	console_cell_t *grid = console->grid;
+	console_cell_t *shadow = console->shadow;
+
+	if (console->num_reserved)
+	{
+		/* Static grid is reused, it only has to be large enough */
+		if (num_cell > console->num_reserved)
+		{
+			return ERR_CODE_FAIL;
+		}
+	}
+	else
+	{
+#ifndef ST7735_STATIC_ONLY
+		grid = calloc(num_cell, sizeof(console_cell_t));
+		shadow = calloc(num_cell, sizeof(console_cell_t));
+		if ((grid == NULL) || (shadow == NULL))
+		{
+			free(grid);
+			free(shadow);
+			return ERR_CODE_FAIL;
+		}
+
+		free(console->grid);
+		free(console->shadow);
+#else
+		return ERR_CODE_FAIL;
+#endif
+	}
+
+	console->handle = config.handle;
+	console->x = config.x;
+	console->y = config.y;
+	console->cols = config.cols;
+	console->rows = config.rows;
+	console->font_size = config.font_size;
+	console->cell_width = cell_width;
+	console->cell_height = glyph.height;
+	console->grid = grid;
+	console->shadow = shadow;
+	console->top = 0;
+	console->fg = CONSOLE_COLOR_DEFAULT_FG;
+	console->bg = CONSOLE_COLOR_DEFAULT_BG;
+	console->bold = false;
+	console->state = CONSOLE_STATE_TEXT;
+	console->full_redraw = true;
+
+	memcpy(console->palette, ansi_palette, sizeof(ansi_palette));
+	console->palette[CONSOLE_COLOR_DEFAULT_FG] = config.fg_color;
+	console->palette[CONSOLE_COLOR_DEFAULT_BG] = config.bg_color;
+
+	clear_grid(console);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_console_write(st7735_console_handle_t console, const uint8_t *data, uint16_t len)
+{
+	/* Check if handle structure is NULL */
+	if ((console == NULL) || (console->grid == NULL) || (data == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	for (uint16_t idx = 0; idx < len; idx++)
+	{
+		feed(console, data[idx]);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_console_print(st7735_console_handle_t console, const uint8_t *str)
+{
+	/* Check if handle structure is NULL */
+	if ((console == NULL) || (console->grid == NULL) || (str == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	while (*str)
+	{
+		feed(console, *str++);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_console_clear(st7735_console_handle_t console)
+{
+	/* Check if handle structure is NULL */
+	if ((console == NULL) || (console->grid == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	clear_grid(console);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_console_refresh(st7735_console_handle_t console)
+{
+	/* Check if handle structure is NULL */
+	if ((console == NULL) || (console->grid == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	for (uint8_t row = 0; row < console->rows; row++)
+	{
+		console_cell_t *cell = get_row(console, row);
+		console_cell_t *drawn = &console->shadow[row * console->cols];
+		uint8_t col = 0;
+
+		while (col < console->cols)
+		{
+			if (!console->full_redraw && cell_equal(&cell[col], &drawn[col]))
+			{
+				col++;
+				continue;
+			}
+
+			uint8_t start = col;
+			while ((col < console->cols) && (console->full_redraw || !cell_equal(&cell[col], &drawn[col])))
+			{
+				col++;
+			}
+
+			if (draw_cells(console, row, start, col - start, &cell[start]))
+			{
+				err = ERR_CODE_FAIL;
+				continue;
+			}
+
+			memcpy(&drawn[start], &cell[start], (col - start) * sizeof(console_cell_t));
+		}
+	}
+
+	if (err == ERR_CODE_SUCCESS)
+	{
+		console->full_redraw = false;
+	}
+
+	return err;
+}
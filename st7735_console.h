@@ -0,0 +1,173 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_CONSOLE_H__
+#define __ST7735_CONSOLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "st7735.h"
+
+#define ST7735_CONSOLE_TAB_WIDTH 		8		/*!< Tab stops every this many columns */
+#define ST7735_CONSOLE_ROW_LEN 			256		/*!< Longest pixel row composed at once */
+
+/**
+ * @brief   Console handle structure.
+ */
+typedef struct st7735_console *st7735_console_handle_t;
+
+/**
+ * @brief   Console configuration structure.
+ */
+typedef struct {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	uint8_t 				x;				/*!< Left edge of the grid in pixel */
+	uint8_t 				y;				/*!< Top edge of the grid in pixel */
+	uint8_t 				cols;			/*!< Number of character columns */
+	uint8_t 				rows;			/*!< Number of character rows */
+	font_size_t 			font_size;		/*!< Font size */
+	uint16_t 				fg_color;		/*!< Default text color */
+	uint16_t 				bg_color;		/*!< Default background color */
+} st7735_console_cfg_t;
+
+/*
+ * @brief   Initialize console.
+ *
+ * @note    Written text only updates a character grid in memory.
+ *          st7735_console_refresh compares the grid with what is on the
+ *          panel and redraws the changed cells, so output can arrive
+ *          much faster than the panel is refreshed.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+#ifndef ST7735_STATIC_ONLY
+st7735_console_handle_t st7735_console_init(void);
+#endif
+
+/*
+ * @brief   Get arena space needed by st7735_console_init_static.
+ *
+ * @param   cols Largest number of columns that will be configured.
+ * @param   rows Largest number of rows that will be configured.
+ *
+ * @return  Size in bytes, rounded to ST7735_ARENA_ALIGN.
+ */
+size_t st7735_console_get_static_size(uint8_t cols, uint8_t rows);
+
+/*
+ * @brief   Initialize console with storage carved from a work arena.
+ *
+ * @note    The grid is reserved for cols x rows cells up front.
+ *          st7735_console_set_config fails for larger grids.
+ *
+ * @param   arena Work arena.
+ * @param   cols Largest number of columns that will be configured.
+ * @param   rows Largest number of rows that will be configured.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail, arena exhausted.
+ */
+st7735_console_handle_t st7735_console_init_static(st7735_arena_t *arena, uint8_t cols, uint8_t rows);
+
+/*
+ * @brief   Set configuration parameters. The grid is cleared and fully
+ *          redrawn on the next refresh.
+ *
+ * @note    The console streams pixels and fails on a panel with a render
+ *          queue attached. x plus the grid width and y plus the grid
+ *          height in pixel must not exceed 255.
+ *
+ * @param   console Console handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_console_set_config(st7735_console_handle_t console, st7735_console_cfg_t config);
+
+/*
+ * @brief   Write bytes to the console.
+ *
+ * @note    Handles '\n', '\r', '\t', '\b', SGR color escapes
+ *          (ESC[0m, ESC[1m, ESC[30-37m, ESC[39m, ESC[40-47m, ESC[49m,
+ *          ESC[90-97m, ESC[100-107m), ESC[2J and ESC[K. Text wraps at
+ *          the last column and the grid scrolls up past the last row.
+ *
+ * @param   console Console handle structure.
+ * @param   data Bytes to write.
+ * @param   len Number of bytes.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_console_write(st7735_console_handle_t console, const uint8_t *data, uint16_t len);
+
+/*
+ * @brief   Write null-terminated string to the console.
+ *
+ * @param   console Console handle structure.
+ * @param   str String.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_console_print(st7735_console_handle_t console, const uint8_t *str);
+
+/*
+ * @brief   Clear the grid and move the cursor home.
+ *
+ * @param   console Console handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_console_clear(st7735_console_handle_t console);
+
+/*
+ * @brief   Redraw the cells whose character or colors changed since the
+ *          last refresh. Each run of changed cells on a row is sent as
+ *          opaque glyphs in one address window.
+ *
+ * @param   console Console handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_console_refresh(st7735_console_handle_t console);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_CONSOLE_H__ */
@@ -0,0 +1,149 @@
+#include <stdatomic.h>
+
+#include "st7735_queue.h"
+
+typedef struct {
+	atomic_size_t 			seq;			/*!< Slot sequence number */
+	st7735_cmd_t 			cmd;			/*!< Command */
+} st7735_queue_cell_t;
+
+typedef struct st7735_queue {
+	st7735_queue_cell_t 	*cell;			/*!< Ring storage */
+	size_t 					mask;			/*!< Ring length - 1 */
+	atomic_size_t 			enqueue_pos;	/*!< Next slot claimed by producers */
+	size_t 					dequeue_pos;	/*!< Next slot read by the consumer */
+} st7735_queue_t;
+
+static size_t get_ring_size(uint16_t length)
+{
+	size_t size = 2;
+	while (size < length)
+	{
+		size <<= 1;
+	}
+
+	return size;
+}
+
+static void reset_queue(st7735_queue_t *queue, size_t size)
+{
+	for (size_t idx = 0; idx < size; idx++)
+	{
+		atomic_init(&queue->cell[idx].seq, idx);
+	}
+
+	queue->mask = size - 1;
+	atomic_init(&queue->enqueue_pos, 0);
+	queue->dequeue_pos = 0;
+}
+
+#ifndef ST7735_STATIC_ONLY
+st7735_queue_handle_t st7735_queue_init(uint16_t length)
+{
+	size_t size = get_ring_size(length);
+
+	st7735_queue_handle_t queue = calloc(1, sizeof(st7735_queue_t));
+	if (queue == NULL)
+	{
+		return NULL;
+	}
+
+	queue->cell = calloc(size, sizeof(st7735_queue_cell_t));
+	if (queue->cell == NULL)
+	{
+		free(queue);
+		return NULL;
+	}
+
+	reset_queue(queue, size);
+
+	return queue;
+}
+#endif
+
+size_t st7735_queue_get_static_size(uint16_t length)
+{
+	return ST7735_ARENA_ROUND(sizeof(st7735_queue_t)) + ST7735_ARENA_ROUND(get_ring_size(length) * sizeof(st7735_queue_cell_t));
+}
+
+st7735_queue_handle_t st7735_queue_init_static(st7735_arena_t *arena, uint16_t length)
+{
+	size_t size = get_ring_size(length);
+
+	if (st7735_arena_get_free(arena) < st7735_queue_get_static_size(length))
+	{
+		return NULL;
+	}
+
+	st7735_queue_handle_t queue = st7735_arena_alloc(arena, sizeof(st7735_queue_t));
+	queue->cell = st7735_arena_alloc(arena, size * sizeof(st7735_queue_cell_t));
+	reset_queue(queue, size);
+
+	return queue;
+}
+
+err_code_t st7735_queue_push(st7735_queue_handle_t queue, const st7735_cmd_t *cmd)
+{
+	/* Check if handle structure is NULL */
+	if ((queue == NULL) || (cmd == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	st7735_queue_cell_t *cell;
+	size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+
+	/* Claim a slot whose sequence matches the position, retry if another producer won */
+	while (1)
+	{
+		cell = &queue->cell[pos & queue->mask];
+		size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+		intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+		if (diff == 0)
+		{
+			if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+			        memory_order_relaxed, memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			return ERR_CODE_FAIL;
+		}
+		else
+		{
+			pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+		}
+	}
+
+	cell->cmd = *cmd;
+	atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_queue_pop(st7735_queue_handle_t queue, st7735_cmd_t *cmd)
+{
+	/* Check if handle structure is NULL */
+	if ((queue == NULL) || (cmd == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	size_t pos = queue->dequeue_pos;
+	st7735_queue_cell_t *cell = &queue->cell[pos & queue->mask];
+	size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+
+	if ((intptr_t)seq - (intptr_t)(pos + 1) < 0)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	*cmd = cell->cmd;
+	atomic_store_explicit(&cell->seq, pos + queue->mask + 1, memory_order_release);
+	queue->dequeue_pos = pos + 1;
+
+	return ERR_CODE_SUCCESS;
+}
@@ -0,0 +1,150 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_QUEUE_H__
+#define __ST7735_QUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "st7735_arena.h"
+
+#define ST7735_QUEUE_TEXT_LEN 			8		/*!< Characters carried by one text command */
+
+/**
+ * @brief   Queue handle structure.
+ */
+typedef struct st7735_queue *st7735_queue_handle_t;
+
+/**
+ * @brief   Queued command type.
+ */
+typedef enum {
+	ST7735_CMD_FILL = 0,					/*!< Fill screen */
+	ST7735_CMD_FILL_RECT,					/*!< Fill rectangle */
+	ST7735_CMD_PIXEL,						/*!< Draw pixel */
+	ST7735_CMD_LINE,						/*!< Draw line */
+	ST7735_CMD_RECTANGLE,					/*!< Draw rectangle outline */
+	ST7735_CMD_CIRCLE,						/*!< Draw circle */
+	ST7735_CMD_IMAGE,						/*!< Draw image in any pixel format */
+	ST7735_CMD_IMAGE_TRANSPARENT,			/*!< Draw image with color key */
+	ST7735_CMD_IMAGE_MASKED,				/*!< Draw image through alpha mask */
+	ST7735_CMD_TEXT,						/*!< Write characters at current position */
+	ST7735_CMD_TEXT_BG,						/*!< Write characters with opaque background at current position */
+	ST7735_CMD_SET_POSITION,				/*!< Set text position */
+	ST7735_CMD_SET_COLOR_MODE,				/*!< Set interface color mode */
+	ST7735_CMD_PUSH_CLIP,					/*!< Push clip rectangle or viewport */
+	ST7735_CMD_POP_CLIP,					/*!< Pop clip rectangle or viewport */
+} st7735_cmd_type_t;
+
+/**
+ * @brief   Queued command. Images are referenced, not copied.
+ */
+typedef struct {
+	uint8_t 				type;			/*!< Command type */
+	uint8_t 				param;			/*!< Font size, pixel format, mask format, color mode or viewport flag */
+	uint16_t 				color;			/*!< Color or key color */
+	uint16_t 				bg_color;		/*!< Background color */
+	uint8_t 				x;				/*!< x origin or x start */
+	uint8_t 				y;				/*!< y origin or y start */
+	uint8_t 				width;			/*!< Width, x end or radius */
+	uint8_t 				height;			/*!< Height or y end */
+	union {
+		const uint8_t 		*image;			/*!< Image source */
+		uint8_t 			text[ST7735_QUEUE_TEXT_LEN];	/*!< Characters, zero padded */
+		struct {
+			int16_t 		x;				/*!< Clip rectangle x in local coordinates */
+			int16_t 		y;				/*!< Clip rectangle y in local coordinates */
+			uint16_t 		width;			/*!< Clip rectangle width */
+			uint16_t 		height;			/*!< Clip rectangle height */
+		} clip;							/*!< Clip rectangle or viewport */
+	};
+	const uint8_t 			*mask;			/*!< Alpha mask */
+} st7735_cmd_t;
+
+/*
+ * @brief   Initialize lock-free multi-producer command queue.
+ *
+ * @param   length Number of commands, rounded up to a power of two.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+#ifndef ST7735_STATIC_ONLY
+st7735_queue_handle_t st7735_queue_init(uint16_t length);
+#endif
+
+/*
+ * @brief   Get arena space needed by st7735_queue_init_static.
+ *
+ * @param   length Number of commands, rounded up to a power of two.
+ *
+ * @return  Size in bytes, rounded to ST7735_ARENA_ALIGN.
+ */
+size_t st7735_queue_get_static_size(uint16_t length);
+
+/*
+ * @brief   Initialize command queue with storage carved from a work arena.
+ *
+ * @param   arena Work arena.
+ * @param   length Number of commands, rounded up to a power of two.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail, arena exhausted.
+ */
+st7735_queue_handle_t st7735_queue_init_static(st7735_arena_t *arena, uint16_t length);
+
+/*
+ * @brief   Push command. Safe to call from several producers at once.
+ *
+ * @note    Never blocks. A full queue rejects the command.
+ *
+ * @param   queue Queue handle structure.
+ * @param   cmd Command.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, queue is full.
+ */
+err_code_t st7735_queue_push(st7735_queue_handle_t queue, const st7735_cmd_t *cmd);
+
+/*
+ * @brief   Pop command. Must be called from a single consumer.
+ *
+ * @param   queue Queue handle structure.
+ * @param   cmd Command.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, queue is empty.
+ */
+err_code_t st7735_queue_pop(st7735_queue_handle_t queue, st7735_cmd_t *cmd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_QUEUE_H__ */
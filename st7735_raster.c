@@ -0,0 +1,422 @@
+#include <stdatomic.h>
+#include <string.h>
+
+#include "st7735_raster.h"
+
+typedef enum {
+	RASTER_ITEM_RECT = 0,
+	RASTER_ITEM_GRADIENT,
+	RASTER_ITEM_CIRCLE,
+	RASTER_ITEM_IMAGE,
+} raster_item_type_t;
+
+typedef struct {
+	raster_item_type_t 		type;			/*!< Item type */
+	st7735_rect_t 			rect;			/*!< Bounding box */
+	uint16_t 				color;			/*!< Color, gradient start or key color */
+	union {
+		struct {
+			uint16_t 		color_end;		/*!< Gradient end color */
+			bool 			vertical;		/*!< Gradient direction */
+		} gradient;
+		struct {
+			int16_t 		x;				/*!< Center x */
+			int16_t 		y;				/*!< Center y */
+			uint8_t 		radius;			/*!< Radius */
+		} circle;
+		struct {
+			const uint8_t 	*src;			/*!< Image source */
+			bool 			transparent;	/*!< Color key enabled */
+		} image;
+	};
+} raster_item_t;
+
+typedef struct {
+	atomic_uint 			seq;			/*!< Band g may be drawn when seq == g, is ready when seq == g + 1 */
+	uint16_t 				pixel[ST7735_RASTER_BAND_HEIGHT * ST7735_RASTER_MAX_WIDTH];	/*!< Band pixels, host byte order */
+} raster_slot_t;
+
+typedef struct st7735_raster {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	uint16_t 				width;			/*!< Screen width */
+	uint16_t 				height;			/*!< Screen height */
+	uint16_t 				bg_color;		/*!< Background color */
+	uint8_t 				num_item;		/*!< Items in the display list */
+	raster_item_t 			item[ST7735_RASTER_MAX_ITEM];	/*!< Display list */
+	atomic_uint 			next_band;		/*!< Next band to claim, counts across frames */
+	atomic_uint 			end_band;		/*!< First band after the submitted frame */
+	atomic_uint 			frame_base;		/*!< First band of the submitted frame */
+	unsigned int 			sent_band;		/*!< Next band to send, sender only */
+	raster_slot_t 			slot[ST7735_RASTER_NUM_SLOT];	/*!< Completion ring */
+} st7735_raster_t;
+
+static void raster_item(const raster_item_t *item, uint16_t *row, int16_t y, int16_t x0, int16_t x1)
+{
+	switch (item->type)
+	{
+	case RASTER_ITEM_RECT:
+		for (int16_t x = x0; x < x1; x++)
+		{
+			row[x] = item->color;
+		}
+		break;
+
+	case RASTER_ITEM_GRADIENT:
+	{
+		int16_t span = (item->gradient.vertical ? item->rect.height : item->rect.width) - 1;
+		if (item->gradient.vertical)
+		{
+			uint8_t alpha = span ? (uint32_t)(y - item->rect.y) * 255 / span : 0;
+			uint16_t color = st7735_blend_color(item->gradient.color_end, item->color, alpha, 0xFF);
+			for (int16_t x = x0; x < x1; x++)
+			{
+				row[x] = color;
+			}
+		}
+		else
+		{
+			for (int16_t x = x0; x < x1; x++)
+			{
+				uint8_t alpha = span ? (uint32_t)(x - item->rect.x) * 255 / span : 0;
+				row[x] = st7735_blend_color(item->gradient.color_end, item->color, alpha, 0xFF);
+			}
+		}
+		break;
+	}
+
+	case RASTER_ITEM_CIRCLE:
+	{
+		/* Distances in half pixels, coverage ramps across one pixel at the edge */
+		int32_t dy = 2 * (y - item->circle.y);
+		int32_t outer = (2 * item->circle.radius + 1) * (2 * item->circle.radius + 1);
+		int32_t inner = (item->circle.radius > 0) ? (2 * item->circle.radius - 1) * (2 * item->circle.radius - 1) : 0;
+
+		for (int16_t x = x0; x < x1; x++)
+		{
+			int32_t dx = 2 * (x - item->circle.x);
+			int32_t dist = dx * dx + dy * dy;
+
+			if (dist <= inner)
+			{
+				row[x] = item->color;
+			}
+			else if (dist < outer)
+			{
+				row[x] = st7735_blend_color(item->color, row[x], (outer - dist) * 255 / (outer - inner), 0xFF);
+			}
+		}
+		break;
+	}
+
+	case RASTER_ITEM_IMAGE:
+	{
+		const uint8_t *src = &item->image.src[((y - item->rect.y) * item->rect.width + (x0 - item->rect.x)) * 2];
+		for (int16_t x = x0; x < x1; x++, src += 2)
+		{
+			uint16_t color = (src[0] << 8) | src[1];
+			if (!item->image.transparent || (color != item->color))
+			{
+				row[x] = color;
+			}
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+static void raster_band(st7735_raster_t *raster, uint16_t band, uint16_t *pixel)
+{
+	int16_t y_start = band * ST7735_RASTER_BAND_HEIGHT;
+	int16_t y_end = (y_start + ST7735_RASTER_BAND_HEIGHT < raster->height) ? y_start + ST7735_RASTER_BAND_HEIGHT : raster->height;
+
+	for (int16_t y = y_start; y < y_end; y++)
+	{
+		uint16_t *row = &pixel[(y - y_start) * raster->width];
+
+		for (uint16_t x = 0; x < raster->width; x++)
+		{
+			row[x] = raster->bg_color;
+		}
+
+		for (uint8_t idx = 0; idx < raster->num_item; idx++)
+		{
+			const raster_item_t *item = &raster->item[idx];
+			int16_t x0 = (item->rect.x > 0) ? item->rect.x : 0;
+			int16_t x1 = (item->rect.x + item->rect.width < raster->width) ? item->rect.x + item->rect.width : raster->width;
+
+			if ((y >= item->rect.y) && (y < item->rect.y + item->rect.height) && (x0 < x1))
+			{
+				raster_item(item, row, y, x0, x1);
+			}
+		}
+	}
+}
+
+static err_code_t add_item(st7735_raster_handle_t raster, const raster_item_t *item)
+{
+	/* Check if handle structure is NULL */
+	if (raster == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Workers read the display list until the frame is flushed */
+	if (raster->sent_band != atomic_load_explicit(&raster->end_band, memory_order_relaxed))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	if (raster->num_item >= ST7735_RASTER_MAX_ITEM)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	raster->item[raster->num_item++] = *item;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static void reset_slots(st7735_raster_t *raster)
+{
+	atomic_init(&raster->next_band, 0);
+	atomic_init(&raster->end_band, 0);
+	atomic_init(&raster->frame_base, 0);
+	raster->sent_band = 0;
+
+	for (uint8_t idx = 0; idx < ST7735_RASTER_NUM_SLOT; idx++)
+	{
+		atomic_init(&raster->slot[idx].seq, idx);
+	}
+}
+
+#ifndef ST7735_STATIC_ONLY
+st7735_raster_handle_t st7735_raster_init(void)
+{
+	st7735_raster_handle_t raster = calloc(1, sizeof(st7735_raster_t));
+	if (raster == NULL)
+	{
+		return NULL;
+	}
+
+	reset_slots(raster);
+
+	return raster;
+}
+#endif
+
+size_t st7735_raster_get_static_size(void)
+{
+	return ST7735_ARENA_ROUND(sizeof(st7735_raster_t));
+}
+
+st7735_raster_handle_t st7735_raster_init_static(st7735_arena_t *arena)
+{
+	st7735_raster_handle_t raster = st7735_arena_alloc(arena, sizeof(st7735_raster_t));
+	if (raster == NULL)
+	{
+		return NULL;
+	}
+
+	reset_slots(raster);
+
+	return raster;
+}
+
+err_code_t st7735_raster_set_config(st7735_raster_handle_t raster, st7735_raster_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if ((raster == NULL) || (config.handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Band rows are sent with 8-bit panel coordinates */
+	if ((config.width == 0) || (config.width > ST7735_RASTER_MAX_WIDTH) || (config.height == 0) || (config.height > 0xFF))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	if (raster->sent_band != atomic_load_explicit(&raster->end_band, memory_order_relaxed))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	raster->handle = config.handle;
+	raster->width = config.width;
+	raster->height = config.height;
+	raster->bg_color = config.bg_color;
+	raster->num_item = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_raster_clear(st7735_raster_handle_t raster)
+{
+	/* Check if handle structure is NULL */
+	if (raster == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (raster->sent_band != atomic_load_explicit(&raster->end_band, memory_order_relaxed))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	raster->num_item = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_raster_add_rect(st7735_raster_handle_t raster, st7735_rect_t rect, uint16_t color)
+{
+	raster_item_t item = { .type = RASTER_ITEM_RECT, .rect = rect, .color = color };
+
+	return add_item(raster, &item);
+}
+
+err_code_t st7735_raster_add_gradient(st7735_raster_handle_t raster, st7735_rect_t rect, uint16_t color_start, uint16_t color_end, bool vertical)
+{
+	raster_item_t item = { .type = RASTER_ITEM_GRADIENT, .rect = rect, .color = color_start };
+	item.gradient.color_end = color_end;
+	item.gradient.vertical = vertical;
+
+	return add_item(raster, &item);
+}
+
+err_code_t st7735_raster_add_circle(st7735_raster_handle_t raster, int16_t x_origin, int16_t y_origin, uint8_t radius, uint16_t color)
+{
+	/* Bounding box includes the anti-aliased edge */
+	raster_item_t item = { .type = RASTER_ITEM_CIRCLE, .color = color,
+	                       .rect = { x_origin - radius, y_origin - radius, 2 * radius + 1, 2 * radius + 1 } };
+	item.circle.x = x_origin;
+	item.circle.y = y_origin;
+	item.circle.radius = radius;
+
+	return add_item(raster, &item);
+}
+
+err_code_t st7735_raster_add_image(st7735_raster_handle_t raster, st7735_rect_t rect, const uint8_t *image_src, bool transparent, uint16_t key_color)
+{
+	if (image_src == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	raster_item_t item = { .type = RASTER_ITEM_IMAGE, .rect = rect, .color = key_color };
+	item.image.src = image_src;
+	item.image.transparent = transparent;
+
+	return add_item(raster, &item);
+}
+
+err_code_t st7735_raster_submit(st7735_raster_handle_t raster)
+{
+	/* Check if handle structure is NULL */
+	if ((raster == NULL) || (raster->handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	unsigned int end = atomic_load_explicit(&raster->end_band, memory_order_relaxed);
+	if (raster->sent_band != end)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	unsigned int num_band = (raster->height + ST7735_RASTER_BAND_HEIGHT - 1) / ST7735_RASTER_BAND_HEIGHT;
+
+	/* Display list and base are published by the release store of end_band */
+	atomic_store_explicit(&raster->frame_base, end, memory_order_relaxed);
+	atomic_store_explicit(&raster->end_band, end + num_band, memory_order_release);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_raster_work(st7735_raster_handle_t raster)
+{
+	/* Check if handle structure is NULL */
+	if (raster == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	unsigned int band = atomic_load_explicit(&raster->next_band, memory_order_relaxed);
+	raster_slot_t *slot;
+
+	do {
+		if (band >= atomic_load_explicit(&raster->end_band, memory_order_acquire))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		/* Claim only bands whose slot the sender has already released */
+		slot = &raster->slot[band % ST7735_RASTER_NUM_SLOT];
+		if (atomic_load_explicit(&slot->seq, memory_order_acquire) != band)
+		{
+			return ERR_CODE_FAIL;
+		}
+	} while (!atomic_compare_exchange_weak_explicit(&raster->next_band, &band, band + 1,
+	         memory_order_relaxed, memory_order_relaxed));
+
+	unsigned int base = atomic_load_explicit(&raster->frame_base, memory_order_relaxed);
+	raster_band(raster, band - base, slot->pixel);
+
+	atomic_store_explicit(&slot->seq, band + 1, memory_order_release);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_raster_flush(st7735_raster_handle_t raster)
+{
+	/* Check if handle structure is NULL */
+	if ((raster == NULL) || (raster->handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	unsigned int base = atomic_load_explicit(&raster->frame_base, memory_order_relaxed);
+	unsigned int end = atomic_load_explicit(&raster->end_band, memory_order_relaxed);
+	err_code_t err = ERR_CODE_SUCCESS;
+
+	while (raster->sent_band != end)
+	{
+		unsigned int band = raster->sent_band;
+		raster_slot_t *slot = &raster->slot[band % ST7735_RASTER_NUM_SLOT];
+
+		/* Help instead of waiting while the next band is not finished */
+		while (atomic_load_explicit(&slot->seq, memory_order_acquire) != band + 1)
+		{
+			st7735_raster_work(raster);
+		}
+
+		uint16_t y = (band - base) * ST7735_RASTER_BAND_HEIGHT;
+		uint16_t height = (y + ST7735_RASTER_BAND_HEIGHT < raster->height) ? ST7735_RASTER_BAND_HEIGHT : raster->height - y;
+
+		/* Keep sending later bands so every slot is recycled, report the failure */
+		if (st7735_stream_begin(raster->handle, 0, y, raster->width, height))
+		{
+			err = ERR_CODE_FAIL;
+		}
+		else
+		{
+			if (st7735_stream_write(raster->handle, slot->pixel, ST7735_PIXEL_FORMAT_RGB565, (uint32_t)raster->width * height))
+			{
+				err = ERR_CODE_FAIL;
+			}
+
+			if (st7735_stream_end(raster->handle))
+			{
+				err = ERR_CODE_FAIL;
+			}
+		}
+
+		atomic_store_explicit(&slot->seq, band + ST7735_RASTER_NUM_SLOT, memory_order_release);
+		raster->sent_band = band + 1;
+	}
+
+	return err;
+}
@@ -0,0 +1,226 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_RASTER_H__
+#define __ST7735_RASTER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "st7735.h"
+
+#define ST7735_RASTER_BAND_HEIGHT 		8		/*!< Rows per band */
+#define ST7735_RASTER_NUM_SLOT 			4		/*!< Finished bands buffered between workers and sender */
+#define ST7735_RASTER_MAX_WIDTH 		160		/*!< Widest screen supported */
+#define ST7735_RASTER_MAX_ITEM 			64		/*!< Display list capacity */
+
+/**
+ * @brief   Band rasterizer handle structure.
+ */
+typedef struct st7735_raster *st7735_raster_handle_t;
+
+/**
+ * @brief   Band rasterizer configuration structure.
+ */
+typedef struct {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	uint16_t 				width;			/*!< Screen width */
+	uint16_t 				height;			/*!< Screen height, at most 255 */
+	uint16_t 				bg_color;		/*!< Color under all items */
+} st7735_raster_cfg_t;
+
+/*
+ * @brief   Initialize band rasterizer.
+ *
+ * @note    A frame is described as a display list, then split into
+ *          horizontal bands. Any number of worker threads call
+ *          st7735_raster_work to rasterize bands in parallel, while one
+ *          sender calls st7735_raster_flush to stream finished bands in
+ *          order. Workers and sender only meet through atomic slot
+ *          sequence numbers, nobody takes a mutex. The sender rasterizes
+ *          bands itself when no worker is ahead, so the rasterizer also
+ *          works with no workers at all.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+#ifndef ST7735_STATIC_ONLY
+st7735_raster_handle_t st7735_raster_init(void);
+#endif
+
+/*
+ * @brief   Get arena space needed by st7735_raster_init_static.
+ *
+ * @param   None.
+ *
+ * @return  Size in bytes, rounded to ST7735_ARENA_ALIGN.
+ */
+size_t st7735_raster_get_static_size(void);
+
+/*
+ * @brief   Initialize band rasterizer with storage carved from a work arena.
+ *
+ * @param   arena Work arena.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail, arena exhausted.
+ */
+st7735_raster_handle_t st7735_raster_init_static(st7735_arena_t *arena);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param   raster Band rasterizer handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_raster_set_config(st7735_raster_handle_t raster, st7735_raster_cfg_t config);
+
+/*
+ * @brief   Empty the display list.
+ *
+ * @note    The display list belongs to the sender. It can only be changed
+ *          after st7735_raster_flush has sent the previous frame.
+ *
+ * @param   raster Band rasterizer handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, a frame is in flight.
+ */
+err_code_t st7735_raster_clear(st7735_raster_handle_t raster);
+
+/*
+ * @brief   Add filled rectangle to the display list.
+ *
+ * @param   raster Band rasterizer handle structure.
+ * @param   rect Rectangle.
+ * @param   color Color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, list is full or a frame is in flight.
+ */
+err_code_t st7735_raster_add_rect(st7735_raster_handle_t raster, st7735_rect_t rect, uint16_t color);
+
+/*
+ * @brief   Add linear gradient rectangle to the display list.
+ *
+ * @param   raster Band rasterizer handle structure.
+ * @param   rect Rectangle.
+ * @param   color_start Color at the left or top edge.
+ * @param   color_end Color at the right or bottom edge.
+ * @param   vertical Gradient runs top to bottom if true, left to right otherwise.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, list is full or a frame is in flight.
+ */
+err_code_t st7735_raster_add_gradient(st7735_raster_handle_t raster, st7735_rect_t rect, uint16_t color_start, uint16_t color_end, bool vertical);
+
+/*
+ * @brief   Add filled anti-aliased circle to the display list.
+ *
+ * @param   raster Band rasterizer handle structure.
+ * @param   x_origin x center position.
+ * @param   y_origin y center position.
+ * @param   radius Radius.
+ * @param   color Color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, list is full or a frame is in flight.
+ */
+err_code_t st7735_raster_add_circle(st7735_raster_handle_t raster, int16_t x_origin, int16_t y_origin, uint8_t radius, uint16_t color);
+
+/*
+ * @brief   Add sprite to the display list.
+ *
+ * @note    Image format is the same as st7735_draw_image. The image is
+ *          referenced and must stay valid until the frame is flushed.
+ *
+ * @param   raster Band rasterizer handle structure.
+ * @param   rect Sprite position and size.
+ * @param   image_src Image source.
+ * @param   transparent Skip pixels equal to key_color if true.
+ * @param   key_color Transparent color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, list is full or a frame is in flight.
+ */
+err_code_t st7735_raster_add_image(st7735_raster_handle_t raster, st7735_rect_t rect, const uint8_t *image_src, bool transparent, uint16_t key_color);
+
+/*
+ * @brief   Publish the display list as a frame for workers and sender.
+ *
+ * @param   raster Band rasterizer handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, previous frame not flushed.
+ */
+err_code_t st7735_raster_submit(st7735_raster_handle_t raster);
+
+/*
+ * @brief   Rasterize one band. Call from worker threads.
+ *
+ * @note    Never blocks. A band is only claimed when its slot is free, so
+ *          a worker never waits for the sender.
+ *
+ * @param   raster Band rasterizer handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: A band was rasterized.
+ *      - Others:           No band available, yield and try again.
+ */
+err_code_t st7735_raster_work(st7735_raster_handle_t raster);
+
+/*
+ * @brief   Send every band of the submitted frame in order. Call from the
+ *          single sender.
+ *
+ * @note    Each band is sent in its own address window as soon as it is
+ *          finished. While the next band is not ready the sender
+ *          rasterizes a band itself.
+ *
+ * @param   raster Band rasterizer handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_raster_flush(st7735_raster_handle_t raster);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_RASTER_H__ */
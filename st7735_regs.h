@@ -0,0 +1,260 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_REGS_H__
+#define __ST7735_REGS_H__
+
+#include <stdint.h>
+
+#define ST7735_MADCTL_MY  				0x80
+#define ST7735_MADCTL_MX  				0x40
+#define ST7735_MADCTL_MV  				0x20
+#define ST7735_MADCTL_ML  				0x10
+#define ST7735_MADCTL_RGB 				0x00
+#define ST7735_MADCTL_BGR 				0x08
+#define ST7735_MADCTL_MH  				0x04
+
+#define ST7735_XSTART 					2
+#define ST7735_YSTART 					3
+
+#define ST7735_NOP     					0x00
+#define ST7735_SWRESET 					0x01
+#define ST7735_RDDID   					0x04
+#define ST7735_RDDST   					0x09
+
+#define ST7735_SLPIN   					0x10
+#define ST7735_SLPOUT  					0x11
+#define ST7735_PTLON   					0x12
+#define ST7735_NORON   					0x13
+
+#define ST7735_INVOFF  					0x20
+#define ST7735_INVON   					0x21
+#define ST7735_DISPOFF 					0x28
+#define ST7735_DISPON  					0x29
+#define ST7735_SET_COLUMN_ADDR   		0x2A
+#define ST7735_SET_ROW_ADDR   			0x2B
+#define ST7735_RAMWR   					0x2C
+#define ST7735_RAMRD   					0x2E
+
+#define ST7735_PTLAR   					0x30
+#define ST7735_COLMOD  					0x3A
+#define ST7735_MADCTL  					0x36
+
+#define ST7735_FRMCTR1 					0xB1
+#define ST7735_FRMCTR2 					0xB2
+#define ST7735_FRMCTR3 					0xB3
+#define ST7735_INVCTR  					0xB4
+#define ST7735_DISSET5 					0xB6
+
+#define ST7735_PWCTR1  					0xC0
+#define ST7735_PWCTR2  					0xC1
+#define ST7735_PWCTR3  					0xC2
+#define ST7735_PWCTR4  					0xC3
+#define ST7735_PWCTR5  					0xC4
+#define ST7735_VMCTR1  					0xC5
+
+#define ST7735_RDID1   					0xDA
+#define ST7735_RDID2   					0xDB
+#define ST7735_RDID3   					0xDC
+#define ST7735_RDID4   					0xDD
+
+#define ST7735_PWCTR6  					0xFC
+
+#define ST7735_GMCTRP1 					0xE0
+#define ST7735_GMCTRN1 					0xE1
+
+#define ST7735_ROTATION 				(ST7735_MADCTL_MX | ST7735_MADCTL_MY | ST7735_MADCTL_BGR)
+#define ST7735_COLOR565(r, g, b) 		(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xF8) >> 3))
+
+static const uint8_t init_cmds1[] =
+{
+	/*!< 15 commands in list */
+	15,
+
+	/*!< Software reset: 150 ms delay */
+	ST7735_SWRESET,
+	0x80,
+	150,
+
+	/*!< Out of sleep mode: 500 ms delay */
+	ST7735_SLPOUT,
+	0x80,
+	255,
+
+	/*!< Frame rate control: normal mode */
+	ST7735_FRMCTR1,
+	3,
+	0x01,
+	0x2C,
+	0x2D,
+
+	/*!< Frame rate control: idle mode */
+	ST7735_FRMCTR2,
+	3,
+	0x01,
+	0x2C,
+	0x2D,
+
+	/*!< Frame rate control: partial mode */
+	ST7735_FRMCTR3,
+	6,
+	0x01,
+	0x2C,
+	0x2D,
+	0x01,
+	0x2C,
+	0x2D,
+
+	/*!< Display inverse control: no inverse */
+	ST7735_INVCTR,
+	1,
+	0x07,
+
+	/*!< Power control: -4.6V, mode auto */
+	ST7735_PWCTR1,
+	3,
+	0xA2,
+	0x02,
+	0x84,
+
+	/*!< Power control: VGH25 = 2.4C, VGSEL = -10, VGH = 3 * AVDD */
+	ST7735_PWCTR2,
+	1,
+	0xC5,
+
+	/*!< Power control: Opamp current small, boost frequency */
+	ST7735_PWCTR3,
+	2,
+	0x0A,
+	0x00,
+
+	/*!< Power control: BCLK/2, Opamp current small & Medium low */
+	ST7735_PWCTR4,
+	2,
+	0x8A,
+	0x2A,
+
+	/*!< Power control */
+	ST7735_PWCTR5,
+	2,
+	0x8A,
+	0xEE,
+
+	/*!< Power control */
+	ST7735_VMCTR1,
+	1,
+	0x0E,
+
+	/*!< No display inverse */
+	ST7735_INVOFF,
+	0,
+
+	/*!< Memori access control: row_addr/col_addr, bottom to top refresh */
+	ST7735_MADCTL,
+	1,
+	ST7735_ROTATION,
+
+	/*!< Column mode: 16bit color */
+	ST7735_COLMOD,
+	1,
+	0x05
+};
+
+static const uint8_t init_cmds2[] =
+{
+	/*!<  2 commands in list */
+	2,
+
+	/*!< Set column address: START = 0, END = 127 */
+	ST7735_SET_COLUMN_ADDR,
+	4,
+	0x00,
+	0x00,
+	0x00,
+	0x7F,
+
+	/*!< Set row address: START = 0, END = 127 */
+	ST7735_SET_ROW_ADDR,
+	4,
+	0x00,
+	0x00,
+	0x00,
+	0x7F
+};
+
+static const uint8_t init_cmds3[] =
+{
+	/*!<  4 commands in list */
+	4,
+
+	/*!<  Magical unicorn dust */
+	ST7735_GMCTRP1,
+	16,
+	0x02,
+	0x1c,
+	0x07,
+	0x12,
+	0x37,
+	0x32,
+	0x29,
+	0x2d,
+	0x29,
+	0x25,
+	0x2B,
+	0x39,
+	0x00,
+	0x01,
+	0x03,
+	0x10,
+
+	/*!<  Sparkles and rainbows */
+	ST7735_GMCTRN1,
+	16,
+	0x03,
+	0x1d,
+	0x07,
+	0x06,
+	0x2E,
+	0x2C,
+	0x29,
+	0x2D,
+	0x2E,
+	0x2E,
+	0x37,
+	0x3F,
+	0x00,
+	0x00,
+	0x02,
+	0x10,
+
+	/*!<  Normal display on; 10 ms delay */
+	ST7735_NORON,
+	0x80,
+	10,
+
+	/*!<  Main screen turn on; 100 ms delay */
+	ST7735_DISPON,
+	0x80,
+	100
+};
+
+#endif /* __ST7735_REGS_H__ */
@@ -0,0 +1,155 @@
+#include "st7735_rlefont.h"
+
+#define ST7735_RLEFONT_SPAN_BUF 		32		/*!< Spans collected before they are sent */
+
+static const st7735_rlefont_glyph_t *get_glyph(const st7735_rlefont_t *font, uint8_t chr)
+{
+	if ((chr < font->first_char) || (chr > font->last_char))
+	{
+		if (('?' < font->first_char) || ('?' > font->last_char))
+		{
+			return NULL;
+		}
+		chr = '?';
+	}
+
+	return &font->glyphs[chr - font->first_char];
+}
+
+static err_code_t draw_glyph(st7735_handle_t handle, const st7735_rlefont_t *font, const st7735_rlefont_glyph_t *glyph,
+                             int16_t pen_x, int16_t pen_y, uint16_t color, uint16_t bg_color)
+{
+	st7735_span_t spans[ST7735_RLEFONT_SPAN_BUF];
+	uint16_t num_span = 0;
+	uint8_t max_level = (1 << font->bpp) - 1;
+	const uint8_t *data = &font->data[glyph->offset];
+
+	for (uint8_t row = 0; row < glyph->height; row++)
+	{
+		uint8_t num_run = *data++;
+		int16_t x = pen_x + glyph->x_offset;
+		int16_t y = pen_y + glyph->y_offset + row;
+
+		for (uint8_t run = 0; run < num_run; run++)
+		{
+			x += *data++;
+			uint8_t len = *data++;
+			uint8_t level = (font->bpp > 1) ? *data++ : max_level;
+
+			/* Spans use 8-bit panel coordinates, runs crossing an edge are trimmed */
+			int16_t start = (x > 0) ? x : 0;
+			int16_t end = (x + len < 0x100) ? x + len : 0x100;
+
+			if ((y >= 0) && (y < 0x100) && (start < end))
+			{
+				spans[num_span].x = start;
+				spans[num_span].y = y;
+				spans[num_span].len = end - start;
+				spans[num_span].color = (level == max_level) ? color : st7735_blend_color(color, bg_color, level, max_level);
+				num_span++;
+			}
+
+			if (num_span == ST7735_RLEFONT_SPAN_BUF)
+			{
+				if (st7735_draw_spans(handle, spans, num_span))
+				{
+					return ERR_CODE_FAIL;
+				}
+				num_span = 0;
+			}
+
+			x += len;
+		}
+	}
+
+	if (num_span)
+	{
+		return st7735_draw_spans(handle, spans, num_span);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_rlefont_write_char(st7735_handle_t handle, const st7735_rlefont_t *font, uint8_t chr, uint16_t color, uint16_t bg_color)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (font == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	const st7735_rlefont_glyph_t *glyph = get_glyph(font, chr);
+	if (glyph == NULL)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	/* The pen is read on the producer side, which a render queue leaves stale */
+	uint8_t pos_x, pos_y;
+	if (st7735_get_position(handle, &pos_x, &pos_y))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	if (draw_glyph(handle, font, glyph, pos_x, pos_y, color, bg_color))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	return st7735_set_position(handle, pos_x + glyph->advance, pos_y);
+}
+
+err_code_t st7735_rlefont_write_string(st7735_handle_t handle, const st7735_rlefont_t *font, const uint8_t *str, uint16_t color, uint16_t bg_color)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (font == NULL) || (str == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* The pen is read on the producer side, which a render queue leaves stale */
+	uint8_t pos_x, pos_y;
+	if (st7735_get_position(handle, &pos_x, &pos_y))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	int16_t pen_x = pos_x;
+	while (*str)
+	{
+		const st7735_rlefont_glyph_t *glyph = get_glyph(font, *str++);
+		if (glyph == NULL)
+		{
+			continue;
+		}
+
+		if (draw_glyph(handle, font, glyph, pen_x, pos_y, color, bg_color))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		pen_x += glyph->advance;
+	}
+
+	return st7735_set_position(handle, pen_x, pos_y);
+}
+
+err_code_t st7735_rlefont_measure(const st7735_rlefont_t *font, const uint8_t *str, uint16_t *width)
+{
+	if ((font == NULL) || (str == NULL) || (width == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*width = 0;
+	while (*str)
+	{
+		const st7735_rlefont_glyph_t *glyph = get_glyph(font, *str++);
+		if (glyph != NULL)
+		{
+			*width += glyph->advance;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
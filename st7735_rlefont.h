@@ -0,0 +1,114 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_RLEFONT_H__
+#define __ST7735_RLEFONT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "st7735.h"
+
+/**
+ * @brief   Glyph descriptor of a run-length font.
+ *
+ * @note    Glyph data holds one record per row of the bounding box: a run
+ *          count, then for each run the gap from the end of the previous
+ *          run, the run length and, if bpp > 1, the coverage level of the
+ *          run. Pixels not covered by a run are left untouched.
+ */
+typedef struct {
+	uint32_t 				offset;			/*!< Offset of glyph data in font data */
+	uint8_t 				advance;		/*!< Pen advance in pixel */
+	uint8_t 				width;			/*!< Bounding box width */
+	uint8_t 				height;			/*!< Bounding box height */
+	int8_t 					x_offset;		/*!< Bounding box offset from pen x */
+	int8_t 					y_offset;		/*!< Bounding box offset from line top */
+} st7735_rlefont_glyph_t;
+
+/**
+ * @brief   Run-length font. Generated by tools/st7735_fontc.py.
+ */
+typedef struct {
+	uint8_t 				first_char;		/*!< First character in the glyph table */
+	uint8_t 				last_char;		/*!< Last character in the glyph table */
+	uint8_t 				line_height;	/*!< Line height in pixel */
+	uint8_t 				bpp;			/*!< Coverage bits per pixel: 1, 2 or 4 */
+	const st7735_rlefont_glyph_t *glyphs; 	/*!< Glyph table */
+	const uint8_t 			*data;			/*!< Glyph data */
+} st7735_rlefont_t;
+
+/*
+ * @brief   Write character at the current position and advance it.
+ *
+ * @note    Each run is sent as one span. Partial coverage levels are
+ *          blended between color and bg_color. Not available while a
+ *          render queue is attached.
+ *
+ * @param   handle Handle structure.
+ * @param   font Font.
+ * @param   chr Character.
+ * @param 	color Color.
+ * @param 	bg_color Background color used for anti-aliased edges.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_rlefont_write_char(st7735_handle_t handle, const st7735_rlefont_t *font, uint8_t chr, uint16_t color, uint16_t bg_color);
+
+/*
+ * @brief   Write string at the current position and advance it.
+ *
+ * @note    Not available while a render queue is attached.
+ *
+ * @param   handle Handle structure.
+ * @param   font Font.
+ * @param   str String.
+ * @param 	color Color.
+ * @param 	bg_color Background color used for anti-aliased edges.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_rlefont_write_string(st7735_handle_t handle, const st7735_rlefont_t *font, const uint8_t *str, uint16_t color, uint16_t bg_color);
+
+/*
+ * @brief   Measure string width from the advance widths.
+ *
+ * @param   font Font.
+ * @param   str String.
+ * @param   width String width in pixel.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_rlefont_measure(const st7735_rlefont_t *font, const uint8_t *str, uint16_t *width);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_RLEFONT_H__ */
@@ -0,0 +1,424 @@
+#include "st7735_text.h"
+
+typedef struct {
+	const uint8_t 			*start;			/*!< First character of the line */
+	uint16_t 				len;			/*!< Number of characters drawn */
+	uint16_t 				width;			/*!< Line width in pixel */
+} text_line_t;
+
+static uint8_t get_advance(font_size_t font_size, uint8_t chr, uint8_t *height)
+{
+	st7735_glyph_t glyph;
+	st7735_get_glyph(font_size, chr, &glyph);
+
+	if (height != NULL)
+	{
+		*height = glyph.height;
+	}
+
+	return glyph.advance;
+}
+
+/*
+ * Find the next line starting at str. Returns pointer to the start of the
+ * following line, or NULL at the end of the string.
+ */
+static const uint8_t *next_line(font_size_t font_size, const uint8_t *str, uint16_t max_width, text_line_t *line)
+{
+	const uint8_t *break_ptr = NULL;
+	uint16_t break_len = 0, break_width = 0;
+	uint16_t width = 0, len = 0;
+
+	line->start = str;
+
+	while (str[len] && (str[len] != '\n'))
+	{
+		uint8_t advance = get_advance(font_size, str[len], NULL);
+
+		if (max_width && (width + advance > max_width))
+		{
+			if (break_ptr != NULL)
+			{
+				/* Wrap at the last space, the space itself is not drawn */
+				line->len = break_len;
+				line->width = break_width;
+				return break_ptr;
+			}
+
+			if (len == 0)
+			{
+				len = 1;
+				width = advance;
+			}
+
+			/* Word wider than the box, break it here */
+			line->len = len;
+			line->width = width;
+			return &str[len];
+		}
+
+		if (str[len] == ' ')
+		{
+			break_ptr = &str[len + 1];
+			break_len = len;
+			break_width = width;
+		}
+
+		width += advance;
+		len++;
+	}
+
+	line->len = len;
+	line->width = width;
+
+	if (str[len] == '\n')
+	{
+		return &str[len + 1];
+	}
+
+	return NULL;
+}
+
+static uint8_t get_line_height(font_size_t font_size)
+{
+	uint8_t height;
+	get_advance(font_size, ' ', &height);
+
+	return height;
+}
+
+static uint8_t layout(const st7735_text_cfg_t *cfg, const uint8_t *str, text_line_t *lines, st7735_rect_t *rects, uint8_t max_line)
+{
+	uint8_t line_height = get_line_height(cfg->font_size);
+	uint16_t max_width = cfg->wrap ? cfg->box.width : 0;
+	uint8_t num_line = 0;
+	const uint8_t *ptr = str;
+
+	while ((ptr != NULL) && (num_line < max_line))
+	{
+		text_line_t line;
+		int16_t y = cfg->box.y + num_line * line_height;
+
+		if (cfg->box.height && (y + line_height > cfg->box.y + cfg->box.height))
+		{
+			break;
+		}
+
+		ptr = next_line(cfg->font_size, ptr, max_width, &line);
+
+		/* Without wrapping, clip the line to the box */
+		if (!cfg->wrap && cfg->box.width && (line.width > cfg->box.width))
+		{
+			uint16_t width = 0, len = 0;
+			while (len < line.len)
+			{
+				uint8_t advance = get_advance(cfg->font_size, line.start[len], NULL);
+				if (width + advance > cfg->box.width)
+				{
+					break;
+				}
+				width += advance;
+				len++;
+			}
+			line.len = len;
+			line.width = width;
+		}
+
+		int16_t x = cfg->box.x;
+		if (cfg->align == ST7735_TEXT_ALIGN_CENTER)
+		{
+			x += ((int16_t)cfg->box.width - (int16_t)line.width) / 2;
+		}
+		else if (cfg->align == ST7735_TEXT_ALIGN_RIGHT)
+		{
+			x += (int16_t)cfg->box.width - (int16_t)line.width;
+		}
+
+		/* A line wider than the box starts at its left edge, and text
+		 * positions are 8-bit, so nothing may start left of the screen */
+		if (cfg->box.width && (line.width > cfg->box.width))
+		{
+			x = cfg->box.x;
+		}
+		if (x < 0)
+		{
+			x = 0;
+		}
+
+		/* Lines starting outside 0..255 cannot be positioned and are
+		 * skipped, the others are clipped to that range */
+		uint16_t width = line.width;
+		uint16_t height = line_height;
+		if ((y < 0) || (y > 0xFF) || (x > 0xFF))
+		{
+			width = 0;
+		}
+		else
+		{
+			width = (x + width > 0x100) ? 0x100 - x : width;
+			height = (y + height > 0x100) ? 0x100 - y : height;
+		}
+
+		if (lines != NULL)
+		{
+			lines[num_line] = line;
+		}
+
+		rects[num_line].x = x;
+		rects[num_line].y = y;
+		rects[num_line].width = width;
+		rects[num_line].height = height;
+		num_line++;
+
+		/* Stop at a trailing newline, it does not open a visible line */
+		if ((ptr != NULL) && (*ptr == 0))
+		{
+			break;
+		}
+	}
+
+	return num_line;
+}
+
+static void get_extent(const st7735_rect_t *rects, uint8_t num_line, st7735_rect_t *extent)
+{
+	int16_t x0 = INT16_MAX, y0 = INT16_MAX, x1 = INT16_MIN, y1 = INT16_MIN;
+
+	for (uint8_t idx = 0; idx < num_line; idx++)
+	{
+		if (rects[idx].width == 0)
+		{
+			continue;
+		}
+
+		if (rects[idx].x < x0) x0 = rects[idx].x;
+		if (rects[idx].y < y0) y0 = rects[idx].y;
+		if (rects[idx].x + rects[idx].width > x1) x1 = rects[idx].x + rects[idx].width;
+		if (rects[idx].y + rects[idx].height > y1) y1 = rects[idx].y + rects[idx].height;
+	}
+
+	if (x1 < x0)
+	{
+		extent->x = 0;
+		extent->y = 0;
+		extent->width = 0;
+		extent->height = 0;
+		return;
+	}
+
+	extent->x = x0;
+	extent->y = y0;
+	extent->width = x1 - x0;
+	extent->height = y1 - y0;
+}
+
+static err_code_t draw_lines(st7735_handle_t handle, const st7735_text_cfg_t *cfg, const text_line_t *lines, const st7735_rect_t *rects,
+                             uint8_t num_line, uint16_t color, uint16_t bg_color, bool opaque)
+{
+	for (uint8_t line_idx = 0; line_idx < num_line; line_idx++)
+	{
+		if (rects[line_idx].width == 0)
+		{
+			continue;
+		}
+
+		if (st7735_set_position(handle, rects[line_idx].x, rects[line_idx].y))
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		for (uint16_t idx = 0; idx < lines[line_idx].len; idx++)
+		{
+			err_code_t err = opaque ?
+			                 st7735_write_char_bg(handle, cfg->font_size, lines[line_idx].start[idx], color, bg_color) :
+			                 st7735_write_char(handle, cfg->font_size, lines[line_idx].start[idx], color);
+			if (err)
+			{
+				return err;
+			}
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_text_measure(font_size_t font_size, const uint8_t *str, uint16_t max_width, uint16_t *width, uint16_t *height)
+{
+	if ((str == NULL) || (width == NULL) || (height == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t line_height = get_line_height(font_size);
+	uint16_t num_line = 0;
+	const uint8_t *ptr = str;
+
+	*width = 0;
+	while (ptr != NULL)
+	{
+		text_line_t line;
+		ptr = next_line(font_size, ptr, max_width, &line);
+		num_line++;
+
+		if (line.width > *width)
+		{
+			*width = line.width;
+		}
+
+		if ((ptr != NULL) && (*ptr == 0))
+		{
+			break;
+		}
+	}
+
+	*height = (*str) ? num_line * line_height : 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_text_layout(const st7735_text_cfg_t *cfg, const uint8_t *str, st7735_rect_t *lines, uint8_t max_line, uint8_t *num_line)
+{
+	if ((cfg == NULL) || (str == NULL) || (lines == NULL) || (num_line == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*num_line = (*str) ? layout(cfg, str, NULL, lines, max_line) : 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_text_draw(st7735_handle_t handle, const st7735_text_cfg_t *cfg, const uint8_t *str, uint16_t color, st7735_rect_t *extent)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (cfg == NULL) || (str == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	text_line_t lines[ST7735_TEXT_MAX_LINE];
+	st7735_rect_t rects[ST7735_TEXT_MAX_LINE];
+	uint8_t num_line = (*str) ? layout(cfg, str, lines, rects, ST7735_TEXT_MAX_LINE) : 0;
+
+	if (extent != NULL)
+	{
+		get_extent(rects, num_line, extent);
+	}
+
+	return draw_lines(handle, cfg, lines, rects, num_line, color, 0, false);
+}
+
+err_code_t st7735_text_update(st7735_handle_t handle, const st7735_text_cfg_t *cfg, const uint8_t *str, uint16_t color, uint16_t bg_color, st7735_rect_t *extent)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (cfg == NULL) || (str == NULL) || (extent == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	text_line_t lines[ST7735_TEXT_MAX_LINE];
+	st7735_rect_t rects[ST7735_TEXT_MAX_LINE];
+	uint8_t num_line = (*str) ? layout(cfg, str, lines, rects, ST7735_TEXT_MAX_LINE) : 0;
+	st7735_rect_t old = *extent;
+
+	if (draw_lines(handle, cfg, lines, rects, num_line, color, bg_color, true))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/*
+	 * Lines are stacked bands, so the old extent minus the new lines is:
+	 * each band's left and right remainders, plus whatever of the old
+	 * extent lies above the first or below the last band.
+	 */
+	int16_t old_bottom = old.y + old.height;
+	int16_t covered_top = (num_line) ? rects[0].y : old_bottom;
+	int16_t covered_bottom = (num_line) ? rects[num_line - 1].y + rects[num_line - 1].height : old_bottom;
+	st7735_rect_t clear[4];
+
+	for (uint8_t line_idx = 0; line_idx < num_line; line_idx++)
+	{
+		int16_t top = (rects[line_idx].y > old.y) ? rects[line_idx].y : old.y;
+		int16_t bottom = rects[line_idx].y + rects[line_idx].height;
+		if (bottom > old_bottom)
+		{
+			bottom = old_bottom;
+		}
+
+		if ((old.width == 0) || (bottom <= top))
+		{
+			continue;
+		}
+
+		st7735_rect_t band = { old.x, top, old.width, bottom - top };
+		uint8_t num_clear = st7735_rect_subtract(&band, &rects[line_idx], clear);
+
+		for (uint8_t idx = 0; idx < num_clear; idx++)
+		{
+			st7735_fill_rect(handle, clear[idx].x, clear[idx].y, clear[idx].width, clear[idx].height, bg_color);
+		}
+	}
+
+	if (old.width && old.height)
+	{
+		if (covered_top > old.y)
+		{
+			int16_t bottom = (covered_top < old_bottom) ? covered_top : old_bottom;
+			st7735_fill_rect(handle, old.x, old.y, old.width, bottom - old.y, bg_color);
+		}
+
+		if (covered_bottom < old_bottom)
+		{
+			int16_t top = (covered_bottom > old.y) ? covered_bottom : old.y;
+			st7735_fill_rect(handle, old.x, top, old.width, old_bottom - top, bg_color);
+		}
+	}
+
+	get_extent(rects, num_line, extent);
+
+	return ERR_CODE_SUCCESS;
+}
+
+uint8_t st7735_rect_subtract(const st7735_rect_t *a, const st7735_rect_t *b, st7735_rect_t *out)
+{
+	int32_t ax1 = a->x + a->width, ay1 = a->y + a->height;
+	int32_t bx1 = b->x + b->width, by1 = b->y + b->height;
+	uint8_t num = 0;
+
+	if ((a->width == 0) || (a->height == 0))
+	{
+		return 0;
+	}
+
+	/* No overlap, a is unchanged */
+	if ((b->x >= ax1) || (bx1 <= a->x) || (b->y >= ay1) || (by1 <= a->y) || (b->width == 0) || (b->height == 0))
+	{
+		out[0] = *a;
+		return 1;
+	}
+
+	int32_t top = (b->y > a->y) ? b->y : a->y;
+	int32_t bottom = (by1 < ay1) ? by1 : ay1;
+
+	if (b->y > a->y)
+	{
+		out[num++] = (st7735_rect_t) { a->x, a->y, a->width, b->y - a->y };
+	}
+
+	if (by1 < ay1)
+	{
+		out[num++] = (st7735_rect_t) { a->x, by1, a->width, ay1 - by1 };
+	}
+
+	if (b->x > a->x)
+	{
+		out[num++] = (st7735_rect_t) { a->x, top, b->x - a->x, bottom - top };
+	}
+
+	if (bx1 < ax1)
+	{
+		out[num++] = (st7735_rect_t) { bx1, top, ax1 - bx1, bottom - top };
+	}
+
+	return num;
+}
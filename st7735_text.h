@@ -0,0 +1,143 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_TEXT_H__
+#define __ST7735_TEXT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "st7735.h"
+
+#define ST7735_TEXT_MAX_LINE 			16		/*!< Maximum number of lines laid out in one box */
+
+/**
+ * @brief   Horizontal alignment.
+ */
+typedef enum {
+	ST7735_TEXT_ALIGN_LEFT = 0,				/*!< Align to the left edge of the box */
+	ST7735_TEXT_ALIGN_CENTER,				/*!< Center in the box */
+	ST7735_TEXT_ALIGN_RIGHT,				/*!< Align to the right edge of the box */
+} st7735_text_align_t;
+
+/**
+ * @brief   Text layout configuration.
+ */
+typedef struct {
+	st7735_rect_t 			box;			/*!< Layout box. Zero height means unbounded */
+	font_size_t 			font_size;		/*!< Font size */
+	st7735_text_align_t 	align;			/*!< Horizontal alignment of each line */
+	bool 					wrap;			/*!< Wrap words at the box width */
+} st7735_text_cfg_t;
+
+/*
+ * @brief   Measure string extent.
+ *
+ * @note    Newlines start a new line. With a non-zero max_width lines are
+ *          wrapped at spaces, and words wider than max_width are broken.
+ *
+ * @param   font_size Font size.
+ * @param   str String.
+ * @param   max_width Wrap width in pixel, 0 disables wrapping.
+ * @param   width Width of the widest line.
+ * @param   height Total height of all lines.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_text_measure(font_size_t font_size, const uint8_t *str, uint16_t max_width, uint16_t *width, uint16_t *height);
+
+/*
+ * @brief   Lay out string in a box without drawing.
+ *
+ * @param   cfg Layout configuration.
+ * @param   str String.
+ * @param   lines Output rectangle of each line.
+ * @param   max_line Capacity of lines.
+ * @param   num_line Number of lines that fit in the box.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_text_layout(const st7735_text_cfg_t *cfg, const uint8_t *str, st7735_rect_t *lines, uint8_t max_line, uint8_t *num_line);
+
+/*
+ * @brief   Draw string in a box.
+ *
+ * @note    Lines that do not fit the box height are dropped. Without
+ *          wrapping, characters past the box width are dropped. A wrapped
+ *          word wider than the box is left aligned whatever the alignment,
+ *          and no line starts left of column 0. Lines starting above row 0
+ *          or right of column 255 are skipped, and lines are clipped at
+ *          column and row 255.
+ *
+ * @param   handle Handle structure.
+ * @param   cfg Layout configuration.
+ * @param   str String.
+ * @param 	color Color.
+ * @param   extent Bounding rectangle of the drawn text. Can be NULL.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_text_draw(st7735_handle_t handle, const st7735_text_cfg_t *cfg, const uint8_t *str, uint16_t color, st7735_rect_t *extent);
+
+/*
+ * @brief   Replace previously drawn text without clearing the whole box.
+ *
+ * @note    New text is drawn with opaque glyph cells, then only the parts of
+ *          the old extent not covered by the new lines are filled with
+ *          bg_color. Start with a zero-sized extent on first use.
+ *
+ * @param   handle Handle structure.
+ * @param   cfg Layout configuration.
+ * @param   str String.
+ * @param 	color Color.
+ * @param 	bg_color Background color.
+ * @param   extent In: extent of the old text. Out: extent of the new text.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_text_update(st7735_handle_t handle, const st7735_text_cfg_t *cfg, const uint8_t *str, uint16_t color, uint16_t bg_color, st7735_rect_t *extent);
+
+/*
+ * @brief   Subtract rectangle b from rectangle a.
+ *
+ * @param   a Rectangle to subtract from.
+ * @param   b Rectangle to remove.
+ * @param   out Output, room for 4 rectangles.
+ *
+ * @return  Number of rectangles written to out.
+ */
+uint8_t st7735_rect_subtract(const st7735_rect_t *a, const st7735_rect_t *b, st7735_rect_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_TEXT_H__ */
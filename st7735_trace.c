@@ -0,0 +1,180 @@
+#include <string.h>
+
+#include "st7735_trace.h"
+
+typedef struct st7735_trace {
+	st7735_trace_func_get_time get_time;	/*!< Function get time in microsecond */
+	bool 					enable;			/*!< Record events */
+	uint32_t 				capacity;		/*!< Number of records in the ring */
+	uint32_t 				pos;			/*!< Next record written */
+	bool 					wrapped;		/*!< Oldest records were overwritten */
+	uint8_t 				*buf;			/*!< Blob, header followed by the record ring */
+} st7735_trace_t;
+
+static void put_u32(uint8_t *dst, uint32_t value)
+{
+	dst[0] = value & 0xFF;
+	dst[1] = (value >> 8) & 0xFF;
+	dst[2] = (value >> 16) & 0xFF;
+	dst[3] = value >> 24;
+}
+
+static size_t get_buf_size(uint32_t capacity)
+{
+	return ST7735_TRACE_HEADER_LEN + (size_t)capacity * ST7735_TRACE_RECORD_LEN;
+}
+
+static void reset_trace(st7735_trace_t *trace, uint32_t capacity)
+{
+	trace->capacity = capacity;
+	trace->pos = 0;
+	trace->wrapped = false;
+	trace->enable = true;
+
+	memcpy(trace->buf, "S7TR", 4);
+	trace->buf[4] = ST7735_TRACE_VERSION;
+	trace->buf[5] = ST7735_TRACE_RECORD_LEN;
+	trace->buf[6] = 0;
+	trace->buf[7] = 0;
+	put_u32(&trace->buf[8], capacity);
+	put_u32(&trace->buf[12], 0);
+}
+
+#ifndef ST7735_STATIC_ONLY
+st7735_trace_handle_t st7735_trace_init(uint32_t capacity)
+{
+	if (capacity == 0)
+	{
+		return NULL;
+	}
+
+	st7735_trace_handle_t trace = calloc(1, sizeof(st7735_trace_t));
+	if (trace == NULL)
+	{
+		return NULL;
+	}
+
+	trace->buf = calloc(1, get_buf_size(capacity));
+	if (trace->buf == NULL)
+	{
+		free(trace);
+		return NULL;
+	}
+
+	reset_trace(trace, capacity);
+
+	return trace;
+}
+#endif
+
+size_t st7735_trace_get_static_size(uint32_t capacity)
+{
+	return ST7735_ARENA_ROUND(sizeof(st7735_trace_t)) + ST7735_ARENA_ROUND(get_buf_size(capacity));
+}
+
+st7735_trace_handle_t st7735_trace_init_static(st7735_arena_t *arena, uint32_t capacity)
+{
+	if ((capacity == 0) || (st7735_arena_get_free(arena) < st7735_trace_get_static_size(capacity)))
+	{
+		return NULL;
+	}
+
+	st7735_trace_handle_t trace = st7735_arena_alloc(arena, sizeof(st7735_trace_t));
+	trace->buf = st7735_arena_alloc(arena, get_buf_size(capacity));
+	reset_trace(trace, capacity);
+
+	return trace;
+}
+
+err_code_t st7735_trace_set_config(st7735_trace_handle_t trace, st7735_trace_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (trace == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	trace->get_time = config.get_time;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_trace_set_enable(st7735_trace_handle_t trace, bool enable)
+{
+	/* Check if handle structure is NULL */
+	if (trace == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	trace->enable = enable;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_trace_clear(st7735_trace_handle_t trace)
+{
+	/* Check if handle structure is NULL */
+	if (trace == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	trace->pos = 0;
+	trace->wrapped = false;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_trace_record(st7735_trace_handle_t trace, st7735_trace_event_t event, const uint8_t *data, uint16_t len)
+{
+	/* Check if handle structure is NULL */
+	if (trace == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (!trace->enable)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	uint8_t *record = &trace->buf[ST7735_TRACE_HEADER_LEN + trace->pos * ST7735_TRACE_RECORD_LEN];
+
+	put_u32(record, (trace->get_time != NULL) ? trace->get_time() : 0);
+	record[4] = event;
+	record[5] = 0;
+	record[6] = len & 0xFF;
+	record[7] = len >> 8;
+
+	/* Head bytes carry command opcodes and window parameters for replay */
+	for (uint8_t idx = 0; idx < ST7735_TRACE_HEAD_LEN; idx++)
+	{
+		record[8 + idx] = ((data != NULL) && (idx < len)) ? data[idx] : 0;
+	}
+
+	if (++trace->pos == trace->capacity)
+	{
+		trace->pos = 0;
+		trace->wrapped = true;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_trace_get_buffer(st7735_trace_handle_t trace, const uint8_t **data, uint32_t *len)
+{
+	/* Check if handle structure is NULL */
+	if ((trace == NULL) || (data == NULL) || (len == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	trace->buf[6] = trace->wrapped ? ST7735_TRACE_FLAG_WRAPPED : 0;
+	put_u32(&trace->buf[12], trace->pos);
+
+	*data = trace->buf;
+	*len = get_buf_size(trace->wrapped ? trace->capacity : trace->pos);
+
+	return ERR_CODE_SUCCESS;
+}
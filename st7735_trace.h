@@ -0,0 +1,188 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef __ST7735_TRACE_H__
+#define __ST7735_TRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include "err_code.h"
+#include "st7735_arena.h"
+
+/*
+ * Trace blob, read back with st7735_trace_get_buffer and decoded by
+ * tools/st7735_trace.py. Multi-byte fields are little endian.
+ *
+ *   Header, 16 bytes:
+ *     "S7TR", version (1), record length (12), flags (u8, bit 0 set once
+ *     the ring wrapped), reserved (u8), capacity in records (u32), index
+ *     of the next record written (u32).
+ *
+ *   Records follow in ring order. Before the ring wraps only the records
+ *   below the next index are present, after it the oldest one sits at the
+ *   next index:
+ *     timestamp in microseconds (u32), event (u8), reserved (u8),
+ *     length in bytes (u16), first 4 bytes of the transfer, zero padded.
+ *
+ * DC is driven on every transfer, a command record is a DC low edge and a
+ * data or read record a DC high edge.
+ */
+
+#define ST7735_TRACE_VERSION 			1		/*!< Trace format version */
+#define ST7735_TRACE_HEADER_LEN 		16		/*!< Blob header length */
+#define ST7735_TRACE_RECORD_LEN 		12		/*!< Record length */
+#define ST7735_TRACE_HEAD_LEN 			4		/*!< Transfer bytes kept in each record */
+#define ST7735_TRACE_FLAG_WRAPPED 		0x01	/*!< Oldest records were overwritten */
+
+typedef uint32_t (*st7735_trace_func_get_time)(void);
+
+/**
+ * @brief   Bus tracer handle structure.
+ */
+typedef struct st7735_trace *st7735_trace_handle_t;
+
+/**
+ * @brief   Traced bus event.
+ */
+typedef enum {
+	ST7735_TRACE_CS_ASSERT = 0,				/*!< CS driven low, transaction starts */
+	ST7735_TRACE_CS_RELEASE,				/*!< CS driven high, transaction ends */
+	ST7735_TRACE_CMD,						/*!< Command byte sent with DC low */
+	ST7735_TRACE_DATA,						/*!< Data sent with DC high */
+	ST7735_TRACE_READ,						/*!< Data read with DC high */
+} st7735_trace_event_t;
+
+/**
+ * @brief   Bus tracer configuration structure.
+ */
+typedef struct {
+	st7735_trace_func_get_time get_time;	/*!< Function get time in microsecond, NULL records zero */
+} st7735_trace_cfg_t;
+
+/*
+ * @brief   Initialize bus tracer.
+ *
+ * @param   capacity Number of records kept, older ones are overwritten.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+#ifndef ST7735_STATIC_ONLY
+st7735_trace_handle_t st7735_trace_init(uint32_t capacity);
+#endif
+
+/*
+ * @brief   Get arena space needed by st7735_trace_init_static.
+ *
+ * @param   capacity Number of records kept.
+ *
+ * @return  Size in bytes, rounded to ST7735_ARENA_ALIGN.
+ */
+size_t st7735_trace_get_static_size(uint32_t capacity);
+
+/*
+ * @brief   Initialize bus tracer with storage carved from a work arena.
+ *
+ * @param   arena Work arena.
+ * @param   capacity Number of records kept, older ones are overwritten.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail, arena exhausted.
+ */
+st7735_trace_handle_t st7735_trace_init_static(st7735_arena_t *arena, uint32_t capacity);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param   trace Tracer handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_trace_set_config(st7735_trace_handle_t trace, st7735_trace_cfg_t config);
+
+/*
+ * @brief   Start or pause recording.
+ *
+ * @param   trace Tracer handle structure.
+ * @param   enable Record events if true.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_trace_set_enable(st7735_trace_handle_t trace, bool enable);
+
+/*
+ * @brief   Drop every record.
+ *
+ * @param   trace Tracer handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_trace_clear(st7735_trace_handle_t trace);
+
+/*
+ * @brief   Record one bus event. Called by the driver of the panel the
+ *          tracer is attached to, see st7735_set_trace.
+ *
+ * @param   trace Tracer handle structure.
+ * @param   event Event.
+ * @param   data Transferred bytes, NULL for CS events.
+ * @param   len Number of transferred bytes.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_trace_record(st7735_trace_handle_t trace, st7735_trace_event_t event, const uint8_t *data, uint16_t len);
+
+/*
+ * @brief   Get trace blob, header followed by the record ring.
+ *
+ * @note    The blob is the tracer storage itself, not a copy. Pause
+ *          recording or keep the panel idle while it is written out.
+ *
+ * @param   trace Tracer handle structure.
+ * @param   data Blob.
+ * @param   len Blob length in bytes.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_trace_get_buffer(st7735_trace_handle_t trace, const uint8_t **data, uint32_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_TRACE_H__ */
@@ -0,0 +1,656 @@
+#include <string.h>
+
+#include "st7735_widget.h"
+
+#define ST7735_SCENE_ROW_LEN 			256		/*!< Longest row composed at once */
+
+typedef enum {
+	WIDGET_NONE = 0,
+	WIDGET_LABEL,
+	WIDGET_BAR,
+	WIDGET_ICON,
+	WIDGET_CHART,
+} widget_type_t;
+
+typedef struct {
+	widget_type_t 			type;			/*!< Widget type */
+	st7735_rect_t 			rect;			/*!< Bounding box */
+	bool 					visible;		/*!< Drawn if true */
+	uint16_t 				color;			/*!< Foreground color */
+	uint16_t 				bg_color;		/*!< Background color of bar and chart */
+	union {
+		struct {
+			font_size_t 	font_size;		/*!< Font size */
+			st7735_text_align_t align;		/*!< Alignment */
+			uint8_t 		text[ST7735_WIDGET_TEXT_LEN];	/*!< Text */
+		} label;
+		struct {
+			uint16_t 		value;			/*!< Current value */
+			uint16_t 		max_value;		/*!< Value of a full bar */
+		} bar;
+		struct {
+			const uint8_t 	*image;			/*!< Image source */
+			bool 			transparent;	/*!< Color key enabled */
+			uint16_t 		key_color;		/*!< Transparent color */
+		} icon;
+		struct {
+			uint8_t 		*samples;		/*!< Ring of rect.width samples */
+			uint16_t 		head;			/*!< Oldest sample index */
+		} chart;
+	};
+} widget_t;
+
+typedef struct st7735_scene {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	uint16_t 				width;			/*!< Screen width */
+	uint16_t 				height;			/*!< Screen height */
+	uint16_t 				bg_color;		/*!< Scene background */
+	uint8_t 				num_widget;		/*!< Number of widgets */
+	widget_t 				widget[ST7735_SCENE_MAX_WIDGET];	/*!< Widgets in z-order */
+	uint8_t 				num_damage;		/*!< Number of damage rectangles */
+	st7735_rect_t 			damage[ST7735_SCENE_MAX_DAMAGE];	/*!< Damage rectangles */
+	uint16_t 				row[ST7735_SCENE_ROW_LEN];	/*!< Row being composed */
+} st7735_scene_t;
+
+static uint32_t rect_area(const st7735_rect_t *rect)
+{
+	return (uint32_t)rect->width * rect->height;
+}
+
+static st7735_rect_t rect_union(const st7735_rect_t *a, const st7735_rect_t *b)
+{
+	int16_t x0 = (a->x < b->x) ? a->x : b->x;
+	int16_t y0 = (a->y < b->y) ? a->y : b->y;
+	int16_t x1 = (a->x + a->width > b->x + b->width) ? a->x + a->width : b->x + b->width;
+	int16_t y1 = (a->y + a->height > b->y + b->height) ? a->y + a->height : b->y + b->height;
+
+	return (st7735_rect_t) { x0, y0, x1 - x0, y1 - y0 };
+}
+
+static bool rect_intersect(const st7735_rect_t *a, const st7735_rect_t *b, st7735_rect_t *out)
+{
+	int16_t x0 = (a->x > b->x) ? a->x : b->x;
+	int16_t y0 = (a->y > b->y) ? a->y : b->y;
+	int16_t x1 = (a->x + a->width < b->x + b->width) ? a->x + a->width : b->x + b->width;
+	int16_t y1 = (a->y + a->height < b->y + b->height) ? a->y + a->height : b->y + b->height;
+
+	if ((x1 <= x0) || (y1 <= y0))
+	{
+		return false;
+	}
+
+	if (out != NULL)
+	{
+		*out = (st7735_rect_t) { x0, y0, x1 - x0, y1 - y0 };
+	}
+
+	return true;
+}
+
+static void add_damage(st7735_scene_t *scene, st7735_rect_t rect)
+{
+	st7735_rect_t screen = { 0, 0, scene->width, scene->height };
+
+	if (!rect_intersect(&rect, &screen, &rect))
+	{
+		return;
+	}
+
+	/* Merge while the union is no larger than the two rectangles apart */
+	for (uint8_t idx = 0; idx < scene->num_damage;)
+	{
+		st7735_rect_t merged = rect_union(&rect, &scene->damage[idx]);
+		if (rect_area(&merged) <= rect_area(&rect) + rect_area(&scene->damage[idx]))
+		{
+			rect = merged;
+			scene->damage[idx] = scene->damage[--scene->num_damage];
+			idx = 0;
+			continue;
+		}
+		idx++;
+	}
+
+	if (scene->num_damage < ST7735_SCENE_MAX_DAMAGE)
+	{
+		scene->damage[scene->num_damage++] = rect;
+		return;
+	}
+
+	/* List full, grow the rectangle that grows least */
+	uint8_t best = 0;
+	uint32_t best_growth = UINT32_MAX;
+	for (uint8_t idx = 0; idx < scene->num_damage; idx++)
+	{
+		st7735_rect_t merged = rect_union(&rect, &scene->damage[idx]);
+		uint32_t growth = rect_area(&merged) - rect_area(&scene->damage[idx]);
+		if (growth < best_growth)
+		{
+			best_growth = growth;
+			best = idx;
+		}
+	}
+
+	scene->damage[best] = rect_union(&rect, &scene->damage[best]);
+}
+
+static st7735_rect_t get_label_text_rect(const widget_t *widget)
+{
+	st7735_glyph_t glyph;
+	uint16_t width = 0;
+
+	for (const uint8_t *chr = widget->label.text; *chr; chr++)
+	{
+		st7735_get_glyph(widget->label.font_size, *chr, &glyph);
+		width += glyph.advance;
+	}
+
+	st7735_get_glyph(widget->label.font_size, ' ', &glyph);
+
+	int16_t x = widget->rect.x;
+	if (widget->label.align == ST7735_TEXT_ALIGN_CENTER)
+	{
+		x += ((int16_t)widget->rect.width - (int16_t)width) / 2;
+	}
+	else if (widget->label.align == ST7735_TEXT_ALIGN_RIGHT)
+	{
+		x += (int16_t)widget->rect.width - (int16_t)width;
+	}
+
+	int16_t y = widget->rect.y + ((int16_t)widget->rect.height - (int16_t)glyph.height) / 2;
+
+	return (st7735_rect_t) { x, y, width, glyph.height };
+}
+
+static st7735_rect_t get_label_extent(const widget_t *widget)
+{
+	st7735_rect_t text = get_label_text_rect(widget);
+	st7735_rect_t extent = { 0, 0, 0, 0 };
+
+	rect_intersect(&text, &widget->rect, &extent);
+
+	return extent;
+}
+
+static void raster_label(const widget_t *widget, int16_t y, int16_t x0, int16_t x1, uint16_t *row)
+{
+	st7735_rect_t text = get_label_text_rect(widget);
+
+	if ((y < text.y) || (y >= text.y + text.height))
+	{
+		return;
+	}
+
+	int16_t pen_x = text.x;
+	uint8_t glyph_row = y - text.y;
+
+	for (const uint8_t *chr = widget->label.text; *chr && (pen_x < x1); chr++)
+	{
+		st7735_glyph_t glyph;
+		st7735_get_glyph(widget->label.font_size, *chr, &glyph);
+
+		for (uint8_t col = 0; col < glyph.advance; col++)
+		{
+			int16_t x = pen_x + col;
+			if ((x >= x0) && (x < x1) && ST7735_GLYPH_PIXEL(&glyph, glyph_row, col))
+			{
+				row[x] = widget->color;
+			}
+		}
+
+		pen_x += glyph.advance;
+	}
+}
+
+static int16_t get_bar_fill(const widget_t *widget)
+{
+	if (widget->bar.max_value == 0)
+	{
+		return 0;
+	}
+
+	return (uint32_t)widget->rect.width * widget->bar.value / widget->bar.max_value;
+}
+
+static void raster_bar(const widget_t *widget, int16_t x0, int16_t x1, uint16_t *row)
+{
+	int16_t fill_end = widget->rect.x + get_bar_fill(widget);
+
+	for (int16_t x = x0; x < x1; x++)
+	{
+		row[x] = (x < fill_end) ? widget->color : widget->bg_color;
+	}
+}
+
+static void raster_icon(const widget_t *widget, int16_t y, int16_t x0, int16_t x1, uint16_t *row)
+{
+	const uint8_t *src = &widget->icon.image[((y - widget->rect.y) * widget->rect.width + (x0 - widget->rect.x)) * 2];
+
+	for (int16_t x = x0; x < x1; x++, src += 2)
+	{
+		uint16_t color = (src[0] << 8) | src[1];
+		if (!widget->icon.transparent || (color != widget->icon.key_color))
+		{
+			row[x] = color;
+		}
+	}
+}
+
+static int16_t get_chart_y(const widget_t *widget, uint16_t col)
+{
+	uint8_t sample = widget->chart.samples[(widget->chart.head + col) % widget->rect.width];
+
+	return widget->rect.y + widget->rect.height - 1 - (uint32_t)sample * (widget->rect.height - 1) / 0xFF;
+}
+
+static void raster_chart(const widget_t *widget, int16_t y, int16_t x0, int16_t x1, uint16_t *row)
+{
+	for (int16_t x = x0; x < x1; x++)
+	{
+		uint16_t col = x - widget->rect.x;
+		int16_t y_cur = get_chart_y(widget, col);
+		int16_t y_prev = (col > 0) ? get_chart_y(widget, col - 1) : y_cur;
+		int16_t y_min = (y_cur < y_prev) ? y_cur : y_prev;
+		int16_t y_max = (y_cur < y_prev) ? y_prev : y_cur;
+
+		/* Each column connects to the previous sample */
+		row[x] = ((y >= y_min) && (y <= y_max)) ? widget->color : widget->bg_color;
+	}
+}
+
+static void raster_row(const widget_t *widget, int16_t y, int16_t x0, int16_t x1, uint16_t *row)
+{
+	int16_t left = (x0 > widget->rect.x) ? x0 : widget->rect.x;
+	int16_t right = (x1 < widget->rect.x + widget->rect.width) ? x1 : widget->rect.x + widget->rect.width;
+
+	if ((left >= right) || (y < widget->rect.y) || (y >= widget->rect.y + widget->rect.height))
+	{
+		return;
+	}
+
+	switch (widget->type)
+	{
+	case WIDGET_LABEL:
+		raster_label(widget, y, left, right, row);
+		break;
+
+	case WIDGET_BAR:
+		raster_bar(widget, left, right, row);
+		break;
+
+	case WIDGET_ICON:
+		raster_icon(widget, y, left, right, row);
+		break;
+
+	case WIDGET_CHART:
+		raster_chart(widget, y, left, right, row);
+		break;
+
+	default:
+		break;
+	}
+}
+
+static err_code_t render_rect(st7735_scene_t *scene, const st7735_rect_t *rect)
+{
+	uint16_t *row = scene->row;
+	widget_t *hits[ST7735_SCENE_MAX_WIDGET];
+	uint8_t num_hit = 0;
+
+	for (uint8_t idx = 0; idx < scene->num_widget; idx++)
+	{
+		if (scene->widget[idx].visible && rect_intersect(&scene->widget[idx].rect, rect, NULL))
+		{
+			hits[num_hit++] = &scene->widget[idx];
+		}
+	}
+
+	if (st7735_stream_begin(scene->handle, rect->x, rect->y, rect->width, rect->height))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* Row buffer is indexed by screen x, only [x0, x1) is composed and sent */
+	int16_t x0 = rect->x, x1 = rect->x + rect->width;
+	for (int16_t y = rect->y; y < rect->y + rect->height; y++)
+	{
+		for (int16_t x = x0; x < x1; x++)
+		{
+			row[x] = scene->bg_color;
+		}
+
+		for (uint8_t idx = 0; idx < num_hit; idx++)
+		{
+			raster_row(hits[idx], y, x0, x1, row);
+		}
+
+		if (st7735_stream_write(scene->handle, &row[x0], ST7735_PIXEL_FORMAT_RGB565, rect->width))
+		{
+			st7735_stream_end(scene->handle);
+			return ERR_CODE_FAIL;
+		}
+	}
+
+	return st7735_stream_end(scene->handle);
+}
+
+static widget_t *get_widget(st7735_scene_handle_t scene, uint8_t id, widget_type_t type)
+{
+	if ((scene == NULL) || (id >= scene->num_widget))
+	{
+		return NULL;
+	}
+
+	widget_t *widget = &scene->widget[id];
+	if ((type != WIDGET_NONE) && (widget->type != type))
+	{
+		return NULL;
+	}
+
+	return widget;
+}
+
+static err_code_t add_widget(st7735_scene_handle_t scene, const widget_t *widget, uint8_t *id)
+{
+	/* Check if handle structure is NULL */
+	if ((scene == NULL) || (id == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (scene->num_widget >= ST7735_SCENE_MAX_WIDGET)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	*id = scene->num_widget;
+	scene->widget[scene->num_widget++] = *widget;
+	add_damage(scene, widget->rect);
+
+	return ERR_CODE_SUCCESS;
+}
+
+#ifndef ST7735_STATIC_ONLY
+st7735_scene_handle_t st7735_scene_init(void)
+{
+	st7735_scene_handle_t scene = calloc(1, sizeof(st7735_scene_t));
+	if (scene == NULL)
+	{
+		return NULL;
+	}
+
+	return scene;
+}
+#endif
+
+size_t st7735_scene_get_static_size(void)
+{
+	return ST7735_ARENA_ROUND(sizeof(st7735_scene_t));
+}
+
+st7735_scene_handle_t st7735_scene_init_static(st7735_arena_t *arena)
+{
+	return st7735_arena_alloc(arena, sizeof(st7735_scene_t));
+}
+
+err_code_t st7735_scene_set_config(st7735_scene_handle_t scene, st7735_scene_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if ((scene == NULL) || (config.handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Render windows use 8-bit panel coordinates */
+	if ((config.width >= ST7735_SCENE_ROW_LEN) || (config.height >= ST7735_SCENE_ROW_LEN))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* Rendering streams each damaged rectangle, which a render queue cannot carry */
+	st7735_queue_handle_t queue;
+	if (st7735_get_queue(config.handle, &queue) || (queue != NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	scene->handle = config.handle;
+	scene->width = config.width;
+	scene->height = config.height;
+	scene->bg_color = config.bg_color;
+	scene->num_damage = 0;
+	add_damage(scene, (st7735_rect_t) { 0, 0, config.width, config.height });
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_scene_add_label(st7735_scene_handle_t scene, st7735_rect_t rect, font_size_t font_size, st7735_text_align_t align, uint16_t color, uint8_t *id)
+{
+	widget_t widget = { .type = WIDGET_LABEL, .rect = rect, .visible = true, .color = color };
+	widget.label.font_size = font_size;
+	widget.label.align = align;
+
+	return add_widget(scene, &widget, id);
+}
+
+err_code_t st7735_scene_add_bar(st7735_scene_handle_t scene, st7735_rect_t rect, uint16_t color, uint16_t bg_color, uint16_t max_value, uint8_t *id)
+{
+	widget_t widget = { .type = WIDGET_BAR, .rect = rect, .visible = true, .color = color, .bg_color = bg_color };
+	widget.bar.max_value = max_value;
+
+	return add_widget(scene, &widget, id);
+}
+
+err_code_t st7735_scene_add_icon(st7735_scene_handle_t scene, st7735_rect_t rect, const uint8_t *image, bool transparent, uint16_t key_color, uint8_t *id)
+{
+	if (image == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	widget_t widget = { .type = WIDGET_ICON, .rect = rect, .visible = true };
+	widget.icon.image = image;
+	widget.icon.transparent = transparent;
+	widget.icon.key_color = key_color;
+
+	return add_widget(scene, &widget, id);
+}
+
+err_code_t st7735_scene_add_chart(st7735_scene_handle_t scene, st7735_rect_t rect, uint16_t color, uint16_t bg_color, uint8_t *samples, uint8_t *id)
+{
+	if (samples == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((rect.width == 0) || (rect.height == 0))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	widget_t widget = { .type = WIDGET_CHART, .rect = rect, .visible = true, .color = color, .bg_color = bg_color };
+	widget.chart.samples = samples;
+	memset(samples, 0, rect.width);
+
+	return add_widget(scene, &widget, id);
+}
+
+err_code_t st7735_scene_set_text(st7735_scene_handle_t scene, uint8_t id, const uint8_t *text)
+{
+	widget_t *widget = get_widget(scene, id, WIDGET_LABEL);
+	if ((widget == NULL) || (text == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (strncmp((const char *)widget->label.text, (const char *)text, ST7735_WIDGET_TEXT_LEN - 1) == 0)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	st7735_rect_t old_extent = get_label_extent(widget);
+
+	strncpy((char *)widget->label.text, (const char *)text, ST7735_WIDGET_TEXT_LEN - 1);
+	widget->label.text[ST7735_WIDGET_TEXT_LEN - 1] = 0;
+
+	st7735_rect_t new_extent = get_label_extent(widget);
+	if (widget->visible)
+	{
+		add_damage(scene, old_extent);
+		add_damage(scene, new_extent);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_scene_set_value(st7735_scene_handle_t scene, uint8_t id, uint16_t value)
+{
+	widget_t *widget = get_widget(scene, id, WIDGET_BAR);
+	if (widget == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (value > widget->bar.max_value)
+	{
+		value = widget->bar.max_value;
+	}
+
+	int16_t old_fill = get_bar_fill(widget);
+	widget->bar.value = value;
+	int16_t new_fill = get_bar_fill(widget);
+
+	if (widget->visible && (old_fill != new_fill))
+	{
+		int16_t left = (old_fill < new_fill) ? old_fill : new_fill;
+		int16_t right = (old_fill < new_fill) ? new_fill : old_fill;
+		add_damage(scene, (st7735_rect_t) { widget->rect.x + left, widget->rect.y, right - left, widget->rect.height });
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_scene_push_sample(st7735_scene_handle_t scene, uint8_t id, uint8_t sample)
+{
+	widget_t *widget = get_widget(scene, id, WIDGET_CHART);
+	if (widget == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	widget->chart.samples[widget->chart.head] = sample;
+	widget->chart.head = (widget->chart.head + 1) % widget->rect.width;
+
+	if (widget->visible)
+	{
+		add_damage(scene, widget->rect);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_scene_set_color(st7735_scene_handle_t scene, uint8_t id, uint16_t color)
+{
+	widget_t *widget = get_widget(scene, id, WIDGET_NONE);
+	if (widget == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (widget->color == color)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	widget->color = color;
+	if (widget->visible)
+	{
+		add_damage(scene, (widget->type == WIDGET_LABEL) ? get_label_extent(widget) : widget->rect);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_scene_set_visible(st7735_scene_handle_t scene, uint8_t id, bool visible)
+{
+	widget_t *widget = get_widget(scene, id, WIDGET_NONE);
+	if (widget == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (widget->visible != visible)
+	{
+		widget->visible = visible;
+		add_damage(scene, widget->rect);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_scene_move(st7735_scene_handle_t scene, uint8_t id, int16_t x, int16_t y)
+{
+	widget_t *widget = get_widget(scene, id, WIDGET_NONE);
+	if (widget == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((widget->rect.x == x) && (widget->rect.y == y))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	if (widget->visible)
+	{
+		add_damage(scene, widget->rect);
+	}
+
+	widget->rect.x = x;
+	widget->rect.y = y;
+
+	if (widget->visible)
+	{
+		add_damage(scene, widget->rect);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_scene_invalidate(st7735_scene_handle_t scene, st7735_rect_t rect)
+{
+	/* Check if handle structure is NULL */
+	if (scene == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	add_damage(scene, rect);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t st7735_scene_render(st7735_scene_handle_t scene)
+{
+	/* Check if handle structure is NULL */
+	if ((scene == NULL) || (scene->handle == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	err_code_t err = ERR_CODE_SUCCESS;
+	uint8_t num_failed = 0;
+
+	/* Rectangles that failed to send stay damaged for the next render */
+	for (uint8_t idx = 0; idx < scene->num_damage; idx++)
+	{
+		if (render_rect(scene, &scene->damage[idx]))
+		{
+			scene->damage[num_failed++] = scene->damage[idx];
+			err = ERR_CODE_FAIL;
+		}
+	}
+
+	scene->num_damage = num_failed;
+
+	return err;
+}
@@ -0,0 +1,277 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __ST7735_WIDGET_H__
+#define __ST7735_WIDGET_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "st7735.h"
+#include "st7735_text.h"
+
+#define ST7735_SCENE_MAX_WIDGET 		32		/*!< Maximum number of widgets in a scene */
+#define ST7735_SCENE_MAX_DAMAGE 		8		/*!< Damage rectangles kept before they are merged */
+#define ST7735_WIDGET_TEXT_LEN 			32		/*!< Label text capacity including terminator */
+
+/**
+ * @brief   Scene handle structure.
+ */
+typedef struct st7735_scene *st7735_scene_handle_t;
+
+/**
+ * @brief   Scene configuration structure.
+ */
+typedef struct {
+	st7735_handle_t 		handle;			/*!< Panel handle */
+	uint16_t 				width;			/*!< Screen width */
+	uint16_t 				height;			/*!< Screen height */
+	uint16_t 				bg_color;		/*!< Color where no widget is drawn */
+} st7735_scene_cfg_t;
+
+/*
+ * @brief   Initialize retained scene.
+ *
+ * @note    Widgets are drawn in the order they were added. Changing a
+ *          widget marks only the area it affects as damaged, and
+ *          st7735_scene_render redraws each damaged rectangle in one
+ *          address window.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+#ifndef ST7735_STATIC_ONLY
+st7735_scene_handle_t st7735_scene_init(void);
+#endif
+
+/*
+ * @brief   Get arena space needed by st7735_scene_init_static.
+ *
+ * @param   None.
+ *
+ * @return  Size in bytes, rounded to ST7735_ARENA_ALIGN.
+ */
+size_t st7735_scene_get_static_size(void);
+
+/*
+ * @brief   Initialize retained scene with storage carved from a work arena.
+ *
+ * @param   arena Work arena.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail, arena exhausted.
+ */
+st7735_scene_handle_t st7735_scene_init_static(st7735_arena_t *arena);
+
+/*
+ * @brief   Set configuration parameters. The whole screen is damaged.
+ *
+ * @note    The scene streams pixels and fails on a panel with a render
+ *          queue attached. Width and height must be below 256.
+ *
+ * @param   scene Scene handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_set_config(st7735_scene_handle_t scene, st7735_scene_cfg_t config);
+
+/*
+ * @brief   Add single-line text label.
+ *
+ * @param   scene Scene handle structure.
+ * @param   rect Label box, text is clipped to it and centered vertically.
+ * @param   font_size Font size.
+ * @param   align Horizontal alignment in the box.
+ * @param 	color Text color.
+ * @param   id Widget ID.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_add_label(st7735_scene_handle_t scene, st7735_rect_t rect, font_size_t font_size, st7735_text_align_t align, uint16_t color, uint8_t *id);
+
+/*
+ * @brief   Add horizontal bar.
+ *
+ * @param   scene Scene handle structure.
+ * @param   rect Bar box.
+ * @param 	color Filled part color.
+ * @param 	bg_color Empty part color.
+ * @param 	max_value Value of a full bar.
+ * @param   id Widget ID.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_add_bar(st7735_scene_handle_t scene, st7735_rect_t rect, uint16_t color, uint16_t bg_color, uint16_t max_value, uint8_t *id);
+
+/*
+ * @brief   Add icon.
+ *
+ * @param   scene Scene handle structure.
+ * @param   rect Icon position and size.
+ * @param   image Image in the format of st7735_draw_image, must stay valid.
+ * @param   transparent Skip pixels equal to key_color.
+ * @param 	key_color Transparent color.
+ * @param   id Widget ID.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_add_icon(st7735_scene_handle_t scene, st7735_rect_t rect, const uint8_t *image, bool transparent, uint16_t key_color, uint8_t *id);
+
+/*
+ * @brief   Add scrolling line chart.
+ *
+ * @param   scene Scene handle structure.
+ * @param   rect Chart box, one sample per column.
+ * @param 	color Line color.
+ * @param 	bg_color Chart background color.
+ * @param   samples Sample storage of rect.width bytes, must stay valid.
+ * @param   id Widget ID.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_add_chart(st7735_scene_handle_t scene, st7735_rect_t rect, uint16_t color, uint16_t bg_color, uint8_t *samples, uint8_t *id);
+
+/*
+ * @brief   Set label text. Only the union of old and new text is damaged.
+ *
+ * @param   scene Scene handle structure.
+ * @param   id Widget ID.
+ * @param   text Text, copied into the widget.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_set_text(st7735_scene_handle_t scene, uint8_t id, const uint8_t *text);
+
+/*
+ * @brief   Set bar value. Only the span between old and new fill is damaged.
+ *
+ * @param   scene Scene handle structure.
+ * @param   id Widget ID.
+ * @param   value Value, saturated at max_value.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_set_value(st7735_scene_handle_t scene, uint8_t id, uint16_t value);
+
+/*
+ * @brief   Append chart sample, the chart scrolls left by one column.
+ *
+ * @param   scene Scene handle structure.
+ * @param   id Widget ID.
+ * @param   sample Sample, 0 at the bottom and 255 at the top of the box.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_push_sample(st7735_scene_handle_t scene, uint8_t id, uint8_t sample);
+
+/*
+ * @brief   Set widget color.
+ *
+ * @param   scene Scene handle structure.
+ * @param   id Widget ID.
+ * @param 	color Color.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_set_color(st7735_scene_handle_t scene, uint8_t id, uint16_t color);
+
+/*
+ * @brief   Show or hide widget.
+ *
+ * @param   scene Scene handle structure.
+ * @param   id Widget ID.
+ * @param   visible Visibility.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_set_visible(st7735_scene_handle_t scene, uint8_t id, bool visible);
+
+/*
+ * @brief   Move widget. Old and new boxes are damaged.
+ *
+ * @param   scene Scene handle structure.
+ * @param   id Widget ID.
+ * @param   x New x origin position.
+ * @param   y New y origin position.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_move(st7735_scene_handle_t scene, uint8_t id, int16_t x, int16_t y);
+
+/*
+ * @brief   Mark area as damaged.
+ *
+ * @param   scene Scene handle structure.
+ * @param   rect Area.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_invalidate(st7735_scene_handle_t scene, st7735_rect_t rect);
+
+/*
+ * @brief   Redraw damaged areas and clear the damage list.
+ *
+ * @note    Areas that fail to send stay in the damage list.
+ *
+ * @param   scene Scene handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t st7735_scene_render(st7735_scene_handle_t scene);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ST7735_WIDGET_H__ */
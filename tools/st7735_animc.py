@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+# MIT License
+#
+# Copyright (c) 2024 phonght32
+#
+# Encode a PNG sequence into the delta-frame stream of st7735_anim.h.
+#
+# Usage:
+#   st7735_animc.py frames/ -o spinner.s7an --fps 20
+#   st7735_animc.py f000.png f001.png f002.png -o spinner -n anim_spinner
+#
+# Only tiles that changed since the previous frame are stored, merged into
+# rectangles and run-length coded. Input needs the Pillow package. With -n
+# the stream is written as <output>.c and <output>.h instead of a raw file.
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b'S7AN'
+VERSION = 1
+FLAG_KEYFRAME = 0x01
+MAX_PACKET = 128
+WINDOW_BYTES = 11  # CASET, RASET and RAMWR with their parameters
+
+
+def load_frames(paths):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit('PNG input needs Pillow: pip install Pillow')
+
+    frames = []
+    size = None
+    for path in paths:
+        image = Image.open(path).convert('RGB')
+        if size is None:
+            size = image.size
+        elif image.size != size:
+            sys.exit('%s: size %dx%d differs from %dx%d' % (path, image.size[0], image.size[1], size[0], size[1]))
+        frames.append([((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3) for r, g, b in image.getdata()])
+
+    return frames, size[0], size[1]
+
+
+def changed_tiles(prev, cur, width, height, tile):
+    cols = (width + tile - 1) // tile
+    rows = (height + tile - 1) // tile
+    dirty = [[False] * cols for _ in range(rows)]
+    for y in range(height):
+        base = y * width
+        for x in range(width):
+            if prev[base + x] != cur[base + x]:
+                dirty[y // tile][x // tile] = True
+    return dirty
+
+
+def merge_tiles(dirty, width, height, tile):
+    # Runs of dirty tiles per tile row, grown downward while the run below matches
+    rects = []
+    open_runs = {}
+    for row, line in enumerate(dirty + [[False] * len(dirty[0])]):
+        runs = []
+        col = 0
+        while col < len(line):
+            if line[col]:
+                start = col
+                while col < len(line) and line[col]:
+                    col += 1
+                runs.append((start, col))
+            col += 1
+        next_runs = {}
+        for run in runs:
+            next_runs[run] = open_runs.pop(run, row)
+        for (start, end), first_row in open_runs.items():
+            x = start * tile
+            y = first_row * tile
+            rects.append((x, y, min(end * tile, width) - x, min(row * tile, height) - y))
+        open_runs = next_runs
+    return rects
+
+
+def encode_pixels(pixels):
+    data = bytearray()
+    idx = 0
+    literal = []
+
+    def flush_literal():
+        for pos in range(0, len(literal), MAX_PACKET):
+            chunk = literal[pos:pos + MAX_PACKET]
+            data.append(len(chunk) - 1)
+            for pixel in chunk:
+                data.extend(struct.pack('>H', pixel))
+        del literal[:]
+
+    while idx < len(pixels):
+        run = 1
+        while idx + run < len(pixels) and pixels[idx + run] == pixels[idx] and run < MAX_PACKET:
+            run += 1
+        # Two equal pixels cost the same as a literal pair, keep them literal
+        if run >= 3:
+            flush_literal()
+            data.append(0x80 | (run - 1))
+            data += struct.pack('>H', pixels[idx])
+            idx += run
+        else:
+            literal.extend(pixels[idx:idx + run])
+            idx += run
+    flush_literal()
+
+    return data
+
+
+def encode_frame(frame, rects, width, keyframe):
+    body = struct.pack('<HBB', len(rects), FLAG_KEYFRAME if keyframe else 0, 0)
+    for x, y, w, h in rects:
+        body += struct.pack('<BBBB', x, y, w, h)
+        pixels = []
+        for row in range(y, y + h):
+            pixels += frame[row * width + x:row * width + x + w]
+        body += encode_pixels(pixels)
+    return struct.pack('<I', len(body)) + body
+
+
+def bus_cost(rects):
+    # Panel bytes, not stream bytes, decide: every pixel is sent expanded
+    return sum(WINDOW_BYTES + w * h * 2 for x, y, w, h in rects)
+
+
+def encode(frames, width, height, fps, tile, keyframe_interval):
+    if not 0 < width <= 255 or not 0 < height <= 255:
+        sys.exit('frame size %dx%d does not fit in 8-bit rectangles' % (width, height))
+
+    data = bytearray(MAGIC)
+    data += struct.pack('<BBHHHB3x', VERSION, 0, width, height, len(frames), fps)
+    num_keyframe = 0
+    for idx, frame in enumerate(frames):
+        full = encode_frame(frame, [(0, 0, width, height)], width, True)
+        if idx == 0 or (keyframe_interval and idx % keyframe_interval == 0):
+            chunk = full
+        else:
+            rects = merge_tiles(changed_tiles(frames[idx - 1], frame, width, height, tile), width, height, tile)
+            chunk = encode_frame(frame, rects, width, False)
+            if bus_cost(rects) >= bus_cost([(0, 0, width, height)]):
+                chunk = full
+        if chunk is full:
+            num_keyframe += 1
+        data += chunk
+
+    return data, num_keyframe
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Encode a PNG sequence into an st7735 delta-frame animation.')
+    parser.add_argument('input', nargs='+', help='PNG files, or one directory of PNG files played in name order')
+    parser.add_argument('-o', '--output', required=True, help='output file, or path without extension with -n')
+    parser.add_argument('-n', '--name', help='write a C array with this symbol name instead of a raw stream')
+    parser.add_argument('--fps', type=int, default=15, help='frames per second stored in the stream')
+    parser.add_argument('--tile', type=int, default=8, help='change detection tile size in pixels')
+    parser.add_argument('--keyframe-interval', type=int, default=0, help='force a keyframe every N frames, 0 only the first')
+    args = parser.parse_args()
+
+    if len(args.input) == 1 and os.path.isdir(args.input[0]):
+        paths = sorted(os.path.join(args.input[0], name) for name in os.listdir(args.input[0])
+                       if name.lower().endswith('.png'))
+    else:
+        paths = args.input
+    if not paths:
+        sys.exit('no input frames')
+    if len(paths) > 0xFFFF:
+        sys.exit('%d frames do not fit in 16 bits' % len(paths))
+    if not 0 <= args.fps <= 255:
+        sys.exit('fps %d does not fit in 8 bits' % args.fps)
+
+    frames, width, height = load_frames(paths)
+    data, num_keyframe = encode(frames, width, height, args.fps, args.tile, args.keyframe_interval)
+
+    if args.name is None:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+    else:
+        base = os.path.basename(args.output)
+        with open(args.output + '.h', 'w') as f:
+            guard = '__%s_H__' % base.upper()
+            f.write('/* Generated by st7735_animc.py */\n\n')
+            f.write('#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n' % (guard, guard))
+            f.write('#define %s_LEN \t%d\n\n' % (args.name.upper(), len(data)))
+            f.write('extern const uint8_t %s[%d];\n\n#endif /* %s */\n' % (args.name, len(data), guard))
+        with open(args.output + '.c', 'w') as f:
+            f.write('/* Generated by st7735_animc.py */\n\n')
+            f.write('#include "%s.h"\n\n' % base)
+            f.write('const uint8_t %s[%d] =\n{\n' % (args.name, len(data)))
+            for idx in range(0, len(data), 16):
+                f.write('\t' + ', '.join('0x%02X' % b for b in data[idx:idx + 16]) + ',\n')
+            f.write('};\n')
+
+    raw_size = len(frames) * width * height * 2
+    print('%d frames %dx%d, %d keyframes, %d bytes (%d bytes as raw frames)'
+          % (len(frames), width, height, num_keyframe, len(data), raw_size))
+
+
+if __name__ == '__main__':
+    main()
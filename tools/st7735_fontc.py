@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+# MIT License
+#
+# Copyright (c) 2024 phonght32
+#
+# Compile BDF or TTF fonts into the run-length format of st7735_rlefont.h.
+#
+# Usage:
+#   st7735_fontc.py font.bdf -n font_mono_12 -o font_mono_12
+#   st7735_fontc.py font.ttf -s 16 -b 4 -n font_sans_16 -o font_sans_16
+#
+# Writes <output>.c and <output>.h. TTF input needs the freetype-py package.
+
+import argparse
+import os
+import sys
+
+
+class Glyph:
+    def __init__(self, advance, x_offset, y_offset, rows):
+        self.advance = advance
+        self.x_offset = x_offset
+        self.y_offset = y_offset
+        # rows: list of lists of coverage 0..255
+        self.rows = rows
+
+
+def load_bdf(path, first, last):
+    glyphs = {}
+    ascent = None
+    line_height = None
+    with open(path, 'r', encoding='latin-1') as f:
+        lines = iter(f.read().splitlines())
+
+    for line in lines:
+        parts = line.split()
+        if not parts:
+            continue
+        if parts[0] == 'FONT_ASCENT':
+            ascent = int(parts[1])
+        elif parts[0] == 'FONTBOUNDINGBOX':
+            line_height = int(parts[2])
+            if ascent is None:
+                ascent = int(parts[2]) + int(parts[4])
+        elif parts[0] == 'STARTCHAR':
+            code = advance = None
+            bbx = (0, 0, 0, 0)
+            bitmap = []
+            for line in lines:
+                parts = line.split()
+                if not parts:
+                    continue
+                if parts[0] == 'ENCODING':
+                    code = int(parts[1])
+                elif parts[0] == 'DWIDTH':
+                    advance = int(parts[1])
+                elif parts[0] == 'BBX':
+                    bbx = tuple(int(v) for v in parts[1:5])
+                elif parts[0] == 'BITMAP':
+                    for line in lines:
+                        if line.strip() == 'ENDCHAR':
+                            break
+                        bitmap.append(line.strip())
+                    break
+            if code is None or code < first or code > last:
+                continue
+            width, height, x_off, y_off = bbx
+            rows = []
+            for hex_row in bitmap[:height]:
+                bits = int(hex_row, 16)
+                num_bit = len(hex_row) * 4
+                rows.append([255 if (bits >> (num_bit - 1 - x)) & 1 else 0 for x in range(width)])
+            if advance is None:
+                advance = width + x_off
+            glyphs[code] = Glyph(advance, x_off, ascent - (y_off + height), rows)
+
+    if ascent is None or line_height is None:
+        sys.exit('%s: missing FONTBOUNDINGBOX' % path)
+
+    return glyphs, line_height
+
+
+def load_ttf(path, size, bpp, first, last):
+    try:
+        import freetype
+    except ImportError:
+        sys.exit('TTF input needs freetype-py: pip install freetype-py')
+
+    face = freetype.Face(path)
+    face.set_pixel_sizes(0, size)
+    ascent = face.size.ascender >> 6
+    line_height = face.size.height >> 6
+    flags = freetype.FT_LOAD_RENDER
+    if bpp == 1:
+        flags |= freetype.FT_LOAD_TARGET_MONO
+
+    glyphs = {}
+    for code in range(first, last + 1):
+        face.load_char(chr(code), flags)
+        slot = face.glyph
+        bitmap = slot.bitmap
+        rows = []
+        for y in range(bitmap.rows):
+            if bpp == 1:
+                row_bytes = bitmap.buffer[y * bitmap.pitch:(y + 1) * bitmap.pitch]
+                rows.append([255 if (row_bytes[x // 8] >> (7 - x % 8)) & 1 else 0 for x in range(bitmap.width)])
+            else:
+                rows.append(list(bitmap.buffer[y * bitmap.pitch:y * bitmap.pitch + bitmap.width]))
+        glyphs[code] = Glyph(slot.advance.x >> 6, slot.bitmap_left, ascent - slot.bitmap_top, rows)
+
+    return glyphs, line_height
+
+
+def encode_glyph(glyph, bpp):
+    max_level = (1 << bpp) - 1
+    data = bytearray()
+    for row in glyph.rows:
+        levels = [(v * max_level + 127) // 255 for v in row]
+        runs = []
+        x = 0
+        prev_end = 0
+        while x < len(levels):
+            if levels[x] == 0:
+                x += 1
+                continue
+            level = levels[x]
+            start = x
+            while x < len(levels) and levels[x] == level and x - start < 255:
+                x += 1
+            runs.append((start - prev_end, x - start, level))
+            prev_end = x
+        if len(runs) > 255:
+            sys.exit('glyph row has more than 255 runs')
+        data.append(len(runs))
+        for gap, length, level in runs:
+            data.append(gap)
+            data.append(length)
+            if bpp > 1:
+                data.append(level)
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile BDF/TTF fonts into st7735 run-length fonts.')
+    parser.add_argument('input', help='BDF or TTF file')
+    parser.add_argument('-n', '--name', required=True, help='C symbol name of the font')
+    parser.add_argument('-o', '--output', required=True, help='output path without extension')
+    parser.add_argument('-s', '--size', type=int, default=16, help='pixel size for TTF input')
+    parser.add_argument('-b', '--bpp', type=int, choices=(1, 2, 4), default=1, help='coverage bits per pixel')
+    parser.add_argument('--first', type=lambda v: int(v, 0), default=0x20, help='first character code')
+    parser.add_argument('--last', type=lambda v: int(v, 0), default=0x7E, help='last character code')
+    args = parser.parse_args()
+
+    if args.input.lower().endswith('.bdf'):
+        glyphs, line_height = load_bdf(args.input, args.first, args.last)
+    else:
+        glyphs, line_height = load_ttf(args.input, args.size, args.bpp, args.first, args.last)
+
+    data = bytearray()
+    table = []
+    padded_size = 0
+    for code in range(args.first, args.last + 1):
+        glyph = glyphs.get(code, Glyph(0, 0, 0, []))
+        width = len(glyph.rows[0]) if glyph.rows else 0
+        for name, value in (('advance', glyph.advance), ('width', width), ('height', len(glyph.rows))):
+            if not 0 <= value <= 255:
+                sys.exit('character 0x%02X: %s %d does not fit in 8 bits' % (code, name, value))
+        for name, value in (('x offset', glyph.x_offset), ('y offset', glyph.y_offset)):
+            if not -128 <= value <= 127:
+                sys.exit('character 0x%02X: %s %d does not fit in 8 bits' % (code, name, value))
+        table.append((code, len(data), glyph.advance, width, len(glyph.rows), glyph.x_offset, glyph.y_offset))
+        data += encode_glyph(glyph, args.bpp)
+        padded_size += ((width + 7) // 8) * len(glyph.rows) * args.bpp
+
+    base = os.path.basename(args.output)
+    with open(args.output + '.h', 'w') as f:
+        guard = '__%s_H__' % base.upper()
+        f.write('/* Generated by st7735_fontc.py from %s */\n\n' % os.path.basename(args.input))
+        f.write('#ifndef %s\n#define %s\n\n#include "st7735_rlefont.h"\n\n' % (guard, guard))
+        f.write('extern const st7735_rlefont_t %s;\n\n#endif /* %s */\n' % (args.name, guard))
+
+    with open(args.output + '.c', 'w') as f:
+        f.write('/* Generated by st7735_fontc.py from %s */\n\n' % os.path.basename(args.input))
+        f.write('#include "%s.h"\n\n' % base)
+        f.write('static const uint8_t %s_data[] =\n{\n' % args.name)
+        for idx in range(0, len(data), 16):
+            f.write('\t' + ', '.join('0x%02X' % b for b in data[idx:idx + 16]) + ',\n')
+        f.write('};\n\n')
+        f.write('static const st7735_rlefont_glyph_t %s_glyphs[] =\n{\n' % args.name)
+        for code, offset, advance, width, height, x_off, y_off in table:
+            label = chr(code) if 0x20 < code < 0x7F and chr(code) not in '\\*/' else '0x%02X' % code
+            f.write('\t{ %d, %d, %d, %d, %d, %d },\t/*!< %s */\n' % (offset, advance, width, height, x_off, y_off, label))
+        f.write('};\n\n')
+        f.write('const st7735_rlefont_t %s =\n{\n' % args.name)
+        f.write('\t0x%02X,\n\t0x%02X,\n\t%d,\n\t%d,\n\t%s_glyphs,\n\t%s_data\n};\n'
+                % (args.first, args.last, line_height, args.bpp, args.name, args.name))
+
+    print('%s: %d glyphs, %d bytes of run data (%d bytes as padded bitmaps)'
+          % (args.name, len(table), len(data), padded_size))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+# MIT License
+#
+# Copyright (c) 2024 phonght32
+#
+# Replay a bus trace captured by st7735_trace.h against a panel model and
+# report the redraw habits that waste bus time.
+#
+# Usage:
+#   st7735_trace.py trace.bin
+#   st7735_trace.py trace.bin --spi-hz 16000000 --tiny 32 --gap-us 500 --top 5
+#
+# The trace file is the blob returned by st7735_trace_get_buffer, written out
+# unchanged. Reported coordinates are GRAM addresses minus --xstart/--ystart.
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'S7TR'
+VERSION = 1
+HEADER_LEN = 16
+FLAG_WRAPPED = 0x01
+
+EV_CS_ASSERT = 0
+EV_CS_RELEASE = 1
+EV_CMD = 2
+EV_DATA = 3
+EV_READ = 4
+
+CMD_CASET = 0x2A
+CMD_RASET = 0x2B
+CMD_RAMWR = 0x2C
+CMD_COLMOD = 0x3A
+
+GRAM_SIZE = 162
+TILE = 8
+
+
+class Record:
+    def __init__(self, time, event, length, head):
+        self.time = time
+        self.event = event
+        self.length = length
+        self.head = head
+
+
+def load_trace(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if len(data) < HEADER_LEN or data[:4] != MAGIC:
+        sys.exit('%s: not an st7735 trace' % path)
+    version, record_len, flags, capacity, next_idx = struct.unpack_from('<BBBxII', data, 4)
+    if version != VERSION:
+        sys.exit('%s: trace version %d, expected %d' % (path, version, VERSION))
+
+    num_record = min(capacity if flags & FLAG_WRAPPED else next_idx, (len(data) - HEADER_LEN) // record_len)
+    raw = []
+    for idx in range(num_record):
+        raw.append(struct.unpack_from('<IBxH4s', data, HEADER_LEN + idx * record_len))
+    if flags & FLAG_WRAPPED:
+        raw = raw[next_idx:] + raw[:next_idx]
+
+    # Timestamps are a 32-bit microsecond counter, unwrap it
+    records = []
+    base = 0
+    prev = None
+    for time, event, length, head in raw:
+        if prev is not None and time < prev:
+            base += 1 << 32
+        prev = time
+        records.append(Record(base + time, event, length, head))
+
+    return records, bool(flags & FLAG_WRAPPED)
+
+
+def bits_per_pixel(colmod):
+    # 18-bit pixels travel as three bytes
+    return {0x03: 12, 0x05: 16, 0x06: 24}.get(colmod & 0x07, 16)
+
+
+class Panel:
+    """GRAM address model: window registers, write pointer and per-pixel write counts."""
+
+    def __init__(self):
+        self.caset = None
+        self.raset = None
+        self.bits = 16
+        self.cmd = None
+        self.pixel = 0
+        self.bit_rem = 0
+        self.pending = {CMD_CASET: False, CMD_RASET: False}
+        self.counts = [0] * (GRAM_SIZE * GRAM_SIZE)
+
+    def window(self):
+        if self.caset is None or self.raset is None:
+            return None
+        (x0, x1), (y0, y1) = self.caset, self.raset
+        if x1 < x0 or y1 < y0:
+            return None
+        return x0, y0, x1 - x0 + 1, y1 - y0 + 1
+
+    def write_pixels(self, length):
+        window = self.window()
+        bits = length * 8 + self.bit_rem
+        num_pixel = bits // self.bits
+        self.bit_rem = bits - num_pixel * self.bits
+        if window is None:
+            return num_pixel
+        x0, y0, width, height = window
+        area = width * height
+        for idx in range(self.pixel, self.pixel + num_pixel):
+            pos = idx % area
+            x = x0 + pos % width
+            y = y0 + pos // width
+            if x < GRAM_SIZE and y < GRAM_SIZE:
+                self.counts[y * GRAM_SIZE + x] += 1
+        self.pixel += num_pixel
+        return num_pixel
+
+
+class Frame:
+    def __init__(self, start):
+        self.start = start
+        self.written = 0
+        self.unique = 0
+
+
+def transfer_us(num_byte, spi_hz):
+    return num_byte * 8 * 1000000.0 / spi_hz
+
+
+def analyse(records, args):
+    panel = Panel()
+    stats = {
+        'cmd': 0, 'data': 0, 'read': 0, 'transaction': 0,
+        'pixel_byte': 0, 'overhead_byte': 0,
+        'redundant_window': 0, 'unused_window': 0,
+        'tiny': 0, 'tiny_byte': 0, 'tiny_transaction': 0,
+    }
+    length_hist = {}
+    windows = {}
+    gaps = []
+    frames = []
+    frame = None
+    tile_overdraw = {}
+    in_cs = False
+    released = False
+    transaction_pixel = 0
+    last_end = None
+    last_cmd = None
+
+    def close_frame():
+        if frame is None:
+            return
+        frame.unique = sum(1 for c in panel.counts if c)
+        frame.written = sum(panel.counts)
+        for pos, count in enumerate(panel.counts):
+            if count > 1:
+                tile = ((pos % GRAM_SIZE) // TILE, (pos // GRAM_SIZE) // TILE)
+                tile_overdraw[tile] = tile_overdraw.get(tile, 0) + count - 1
+        frames.append(frame)
+        panel.counts = [0] * (GRAM_SIZE * GRAM_SIZE)
+
+    for rec in records:
+        num_byte = rec.length if rec.event in (EV_CMD, EV_DATA, EV_READ) else 0
+
+        if last_end is not None and num_byte:
+            gap = rec.time - last_end
+            if gap >= args.gap_us:
+                # CS released anywhere in the gap frees the bus for other devices
+                gaps.append((gap, rec.time, not released, last_cmd))
+            if gap >= args.frame_gap_us:
+                close_frame()
+                frame = None
+        if num_byte:
+            if frame is None:
+                frame = Frame(rec.time)
+            start = rec.time if last_end is None else max(rec.time, last_end)
+            last_end = start + transfer_us(num_byte, args.spi_hz)
+            released = False
+
+        if rec.event == EV_CS_ASSERT:
+            in_cs = True
+            transaction_pixel = 0
+            stats['transaction'] += 1
+        elif rec.event == EV_CS_RELEASE:
+            if in_cs and 0 < transaction_pixel < args.tiny_pixel:
+                stats['tiny_transaction'] += 1
+            in_cs = False
+            released = True
+        elif rec.event == EV_CMD:
+            stats['cmd'] += 1
+            stats['overhead_byte'] += 1
+            panel.cmd = rec.head[0]
+            last_cmd = panel.cmd
+            if panel.cmd == CMD_RAMWR:
+                panel.pixel = 0
+                panel.bit_rem = 0
+        elif rec.event == EV_DATA:
+            stats['data'] += 1
+            head = rec.head
+            if panel.cmd in (CMD_CASET, CMD_RASET) and rec.length >= 4:
+                stats['overhead_byte'] += rec.length
+                value = ((head[0] << 8) | head[1], (head[2] << 8) | head[3])
+                current = panel.caset if panel.cmd == CMD_CASET else panel.raset
+                if panel.pending[panel.cmd]:
+                    stats['unused_window'] += 1
+                elif current == value:
+                    stats['redundant_window'] += 1
+                if panel.cmd == CMD_CASET:
+                    panel.caset = value
+                else:
+                    panel.raset = value
+                panel.pending[panel.cmd] = True
+            elif panel.cmd == CMD_RAMWR:
+                stats['pixel_byte'] += rec.length
+                length_hist[rec.length] = length_hist.get(rec.length, 0) + 1
+                if rec.length < args.tiny:
+                    stats['tiny'] += 1
+                    stats['tiny_byte'] += rec.length
+                num_pixel = panel.write_pixels(rec.length)
+                transaction_pixel += num_pixel
+                panel.pending[CMD_CASET] = panel.pending[CMD_RASET] = False
+                window = panel.window()
+                if window is not None and panel.pixel == num_pixel:
+                    key = (window[0] - args.xstart, window[1] - args.ystart, window[2], window[3])
+                    windows[key] = windows.get(key, 0) + 1
+            else:
+                stats['overhead_byte'] += rec.length
+                if panel.cmd == CMD_COLMOD and rec.length >= 1:
+                    panel.bits = bits_per_pixel(head[0])
+        elif rec.event == EV_READ:
+            stats['read'] += 1
+            stats['overhead_byte'] += rec.length
+
+    close_frame()
+
+    return stats, length_hist, windows, gaps, frames, tile_overdraw
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Replay an st7735 bus trace and report wasteful redraw patterns.')
+    parser.add_argument('input', help='trace blob from st7735_trace_get_buffer')
+    parser.add_argument('--spi-hz', type=float, default=16000000, help='SPI clock used to estimate transfer time')
+    parser.add_argument('--tiny', type=int, default=32, help='pixel transfers below this many bytes count as tiny')
+    parser.add_argument('--tiny-pixel', type=int, default=16, help='transactions below this many pixels count as tiny')
+    parser.add_argument('--gap-us', type=float, default=1000, help='idle time between transfers reported as a gap')
+    parser.add_argument('--frame-gap-us', type=float, default=5000, help='idle time that separates two frames')
+    parser.add_argument('--xstart', type=int, default=2, help='GRAM column offset of the panel')
+    parser.add_argument('--ystart', type=int, default=3, help='GRAM row offset of the panel')
+    parser.add_argument('--top', type=int, default=5, help='entries listed per section')
+    args = parser.parse_args()
+
+    records, wrapped = load_trace(args.input)
+    if not records:
+        sys.exit('%s: trace is empty' % args.input)
+
+    stats, length_hist, windows, gaps, frames, tile_overdraw = analyse(records, args)
+    span = records[-1].time - records[0].time
+    total_byte = stats['pixel_byte'] + stats['overhead_byte']
+    busy = transfer_us(total_byte, args.spi_hz)
+
+    print('%d records over %.1f ms%s' % (len(records), span / 1000.0, ', oldest records lost' if wrapped else ''))
+    print('%d transactions, %d commands, %d data transfers, %d reads'
+          % (stats['transaction'], stats['cmd'], stats['data'], stats['read']))
+    print('%d pixel bytes, %d command and parameter bytes (%.1f%% overhead)'
+          % (stats['pixel_byte'], stats['overhead_byte'], 100.0 * stats['overhead_byte'] / max(total_byte, 1)))
+    print('bus busy %.1f ms at %.1f MHz, %.1f%% of the trace'
+          % (busy / 1000.0, args.spi_hz / 1e6, 100.0 * busy / max(span, 1)))
+
+    print('\nAddress windows')
+    print('  %d redundant: CASET/RASET resent with the value already set' % stats['redundant_window'])
+    print('  %d unused: CASET/RASET replaced before any pixel was written' % stats['unused_window'])
+    for (x, y, w, h), count in sorted(windows.items(), key=lambda item: -item[1])[:args.top]:
+        print('  %5d x  %dx%d at (%d, %d)' % (count, w, h, x, y))
+
+    print('\nTiny transfers')
+    print('  %d pixel transfers under %d bytes, %d bytes total'
+          % (stats['tiny'], args.tiny, stats['tiny_byte']))
+    print('  %d transactions under %d pixels' % (stats['tiny_transaction'], args.tiny_pixel))
+    for length, count in sorted(length_hist.items(), key=lambda item: -item[1])[:args.top]:
+        print('  %5d x  %d bytes' % (count, length))
+
+    print('\nOverdraw')
+    written = sum(frame.written for frame in frames)
+    unique = sum(frame.unique for frame in frames)
+    print('  %d frames, %d pixels written, %d distinct (%.2fx)'
+          % (len(frames), written, unique, written / float(max(unique, 1))))
+    for frame in sorted(frames, key=lambda f: f.unique - f.written)[:args.top]:
+        if frame.written == frame.unique:
+            break
+        print('  frame at %.1f ms: %d written, %d distinct'
+              % ((frame.start - records[0].time) / 1000.0, frame.written, frame.unique))
+    for (tx, ty), count in sorted(tile_overdraw.items(), key=lambda item: -item[1])[:args.top]:
+        print('  %5d extra writes in tile (%d, %d)-(%d, %d)'
+              % (count, tx * TILE - args.xstart, ty * TILE - args.ystart,
+                 (tx + 1) * TILE - 1 - args.xstart, (ty + 1) * TILE - 1 - args.ystart))
+
+    print('\nIdle gaps')
+    held = [gap for gap in gaps if gap[2]]
+    print('  %d gaps over %.0f us, %.1f ms total; %d with CS held, %.1f ms'
+          % (len(gaps), args.gap_us, sum(gap[0] for gap in gaps) / 1000.0,
+             len(held), sum(gap[0] for gap in held) / 1000.0))
+    for gap, time, held_cs, cmd in sorted(gaps, key=lambda g: -g[0])[:args.top]:
+        print('  %8.0f us at %.1f ms%s, after command 0x%02X'
+              % (gap, (time - records[0].time) / 1000.0, ' with CS held' if held_cs else '', cmd or 0))
+
+
+if __name__ == '__main__':
+    main()